@@ -0,0 +1,21 @@
+# Example design-space exploration, covering the hierarchies in validation_runs.sh and their neighbours.
+# Usage: ./explore explore_example.spec gcc_trace.txt [results_file]
+
+# Parameter ranges: comma-separated values, and a..b for the powers of two from a to b
+block_size    = 16, 32
+l1_size       = 512..4096, 1536
+l1_assoc      = 1..8, 3
+vc_num_blocks = 0, 8, 16
+l2_size       = 0, 8192..65536
+l2_assoc      = 2..8
+
+# Budgets (0 = unlimited): total area, and average memory access time in cycles
+area_budget    = 0.5
+latency_budget = 12
+
+# Cost table
+#      structure  area_per_kb  area_per_block  latency  latency_per_size_doubling  latency_per_assoc_doubling
+cost   l1         0.0120       0.00010         1.0      0.10                       0.05
+cost   vc         0.0200       0.00020         1.0      0.00                       0.00
+cost   l2         0.0060       0.00005         6.0      0.25                       0.10
+cost   memory     0            0               100      0                          0
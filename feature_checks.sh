@@ -0,0 +1,163 @@
+#!/bin/bash
+# Self-checks for the simulator features beyond the classic report, which validation_runs.sh does not cover. Each check
+# compares counters from the CSV report against a value they must equal. Prints one line per failure and exits non-zero
+# if any check failed. Run from the repository root after building (make check does both).
+
+failures=0
+
+# counter <level> <name> <sim_cache arguments...>: print one counter of a CSV report
+counter() {
+   local level=$1 name=$2
+   shift 2
+   ./sim_cache "$@" --format=csv | grep "^counter,$level,$name," | cut -d, -f6
+}
+
+# expect <description> <actual> <expected>
+expect() {
+   if [ "$2" != "$3" ]; then
+      echo "FAIL: $1 (got '$2', expected '$3')"
+      failures=$((failures + 1))
+   fi
+}
+
+#Sectored and mixed block-size traffic
+l2_reads=$(counter L2 reads 32 1024 2 0 8192 4 gcc_trace.txt)
+l2_half_block_reads=$(counter L2 reads 32 1024 2 0 8192 4 gcc_trace.txt --l2-block-size=16)
+expect "32B L1 over a 16B L2 doubles L2 block reads" "$l2_half_block_reads" "$((2 * l2_reads))"
+
+l1_read_misses=$(counter L1 read_misses 32 1024 2 0 0 0 gcc_trace.txt --l1-sectors=2)
+l1_write_misses=$(counter L1 write_misses 32 1024 2 0 0 0 gcc_trace.txt --l1-sectors=2)
+memory_read_bytes=$(counter MEM read_bytes 32 1024 2 0 0 0 gcc_trace.txt --l1-sectors=2)
+expect "a 2-sector L1 fetches one 16B sector per miss" "$memory_read_bytes" "$((16 * (l1_read_misses + l1_write_misses)))"
+
+expect "explicit uniform geometry leaves the report unchanged" \
+       "$(./sim_cache 16 1024 2 16 8192 4 gcc_trace.txt --l2-block-size=16 --l1-sectors=1 --l2-sectors=1 | md5sum)" \
+       "$(./sim_cache 16 1024 2 16 8192 4 gcc_trace.txt | md5sum)"
+
+#MRU filter: results and contents never depend on the filter mode (only the recorded config does)
+for mode in last set; do
+   expect "--mru-filter=$mode leaves text results unchanged" \
+          "$(./sim_cache 16 1024 2 16 8192 4 gcc_trace.txt --mru-filter=$mode | md5sum)" \
+          "$(./sim_cache 16 1024 2 16 8192 4 gcc_trace.txt --mru-filter=off | md5sum)"
+   expect "--mru-filter=$mode leaves CSV results and contents unchanged" \
+          "$(./sim_cache 32 2048 4 0 16384 8 gcc_trace.txt --l1-sectors=4 --contents --format=csv --mru-filter=$mode |
+             grep -v '^config,,mru_filter,' | md5sum)" \
+          "$(./sim_cache 32 2048 4 0 16384 8 gcc_trace.txt --l1-sectors=4 --contents --format=csv --mru-filter=off |
+             grep -v '^config,,mru_filter,' | md5sum)"
+done
+
+#Synthetic workload generator
+for pattern in stream stride random zipf chase reuse; do
+   expect "gen:$pattern is deterministic for a fixed seed" \
+          "$(./sim_cache 64 8192 4 0 65536 8 gen:$pattern --accesses=200k --seed=7 --format=csv | md5sum)" \
+          "$(./sim_cache 64 8192 4 0 65536 8 gen:$pattern --accesses=200k --seed=7 --format=csv | md5sum)"
+done
+if [ "$(./sim_cache 64 8192 4 0 0 0 gen:random --accesses=200k --seed=7 --format=csv | md5sum)" = \
+     "$(./sim_cache 64 8192 4 0 0 0 gen:random --accesses=200k --seed=8 --format=csv | md5sum)" ]; then
+   expect "gen:random differs between seeds" "same output" "different output"
+fi
+# Pinned values: a change here means the generated streams changed, and recorded results are no longer comparable
+expect "gen:zipf seed 7 reproduces its recorded stream" \
+       "$(counter L1 read_misses 64 8192 4 0 0 0 gen:zipf --accesses=200k --seed=7)" "102629"
+expect "gen:chase seed 7 reproduces its recorded stream" \
+       "$(counter L1 read_misses 64 8192 4 0 0 0 gen:chase --accesses=200k --seed=7)" "140063"
+l1_reads=$(counter L1 reads 64 8192 4 0 0 0 gen:zipf --accesses=200k)
+l1_writes=$(counter L1 writes 64 8192 4 0 0 0 gen:zipf --accesses=200k)
+expect "gen:zipf issues exactly --accesses accesses" "$((l1_reads + l1_writes))" "200000"
+
+#TLB: a page walk reads one entry per page-table level, 4 for 4 KB pages, 3 for 2 MB and 2 for 1 GB (1 GB pages
+# need 64 GB of physical memory to hold 64 frames)
+for page in 4k:4 2M:3 1G:2; do
+   tlb="--tlb-entries=64 --page-size=${page%:*} --physical-memory=64G"
+   walks=$(counter TLB walks 16 1024 2 0 0 0 gcc_trace.txt $tlb)
+   walk_reads=$(counter TLB walk_reads 16 1024 2 0 0 0 gcc_trace.txt $tlb)
+   expect "--page-size=${page%:*} walks read ${page#*:} entries each" \
+          "$((walk_reads / walks)),$((walk_reads % walks))" "${page#*:},0"
+done
+expect "page walk reads are not counted as L1 CPU reads" \
+       "$(counter L1 reads 16 1024 2 8 8192 4 gcc_trace.txt --tlb-entries=64)" \
+       "$(counter L1 reads 16 1024 2 8 8192 4 gcc_trace.txt)"
+expect "physical memory of fewer than 64 pages is rejected" \
+       "$(./sim_cache 16 1024 2 0 0 0 gcc_trace.txt --tlb-entries=64 --page-size=1G | cut -d: -f1)" "Error"
+expect "TLB settings are recorded in the configuration" \
+       "$(./sim_cache 16 1024 2 0 0 0 gcc_trace.txt --tlb-entries=64 --page-size=2M --format=csv |
+          grep -cE '^config,,((l2_)?tlb_(entries|assoc)|page_size|physical_memory|mapping_seed),')" "7"
+
+#Miss profiler: top-K lists are capped, and the list length is recorded in the configuration
+expect "--profile-top above 1024 is rejected" \
+       "$(./sim_cache 16 1024 2 0 0 0 gcc_trace.txt --profile-top=1025 | cut -d: -f1)" "Error"
+expect "--profile-top=1024 is recorded in the configuration" \
+       "$(./sim_cache 16 1024 2 0 0 0 gcc_trace.txt --profile-top=1024 --format=csv | grep '^config,,profile_top_k,' |
+          cut -d, -f6)" "1024"
+
+#DRAM: row buffer outcomes and read latency on a hand-made trace. A one-block L1 sends every read to memory as one
+# burst; with the default RoRaBaChCo mapping, 0x20000 is row 1 of bank 0 and 0x2000 is row 0 of bank 1.
+rows=$(mktemp)
+printf 'r 0\nr 40\nr 80\nr c0\nr 20000\nr 0\nr 2000\n' > "$rows"
+# row_outcomes <sim_cache arguments...>: print the row hits, misses and conflicts of a run
+row_outcomes() {
+   echo "$(counter DRAM row_hits "$@"),$(counter DRAM row_misses "$@"),$(counter DRAM bank_conflicts "$@")"
+}
+# Unloaded (1000 cycles between arrivals), requests are served in order: tRCD+tCL+burst = 38 cycles per miss,
+# tCL+burst = 21 per hit, and tRP+tRCD+tCL+burst = 55 per conflict
+expect "in-order DRAM row hits, misses and conflicts" \
+       "$(row_outcomes 64 64 1 0 0 0 "$rows" --dram --dram-cycles-per-access=1000)" "3,2,2"
+expect "unloaded DRAM read latency follows the row outcomes" \
+       "$(counter DRAM read_latency_cycles 64 64 1 0 0 0 "$rows" --dram --dram-cycles-per-access=1000)" "249"
+# Queued (1 cycle between arrivals), FR-FCFS serves the second read of row 0 before the read of row 1
+expect "FR-FCFS turns a conflict into a row hit" "$(row_outcomes 64 64 1 0 0 0 "$rows" --dram)" "4,2,1"
+# One-entry queue, arrivals at cycles 0..6: reads complete at 38, 42, 46, 50, 94, 150 and 154, stalls included
+expect "DRAM read latency includes queue-full stalls" \
+       "$(counter DRAM queue_full_stalls 64 64 1 0 0 0 "$rows" --dram --dram-queue-depth=1),$(
+          counter DRAM read_latency_cycles 64 64 1 0 0 0 "$rows" --dram --dram-queue-depth=1)" "4,553"
+expect "a one-entry write queue drains once per write at most" \
+       "$(counter DRAM write_drains 32 1024 2 0 0 0 gcc_trace.txt --dram --dram-queue-depth=1)" \
+       "$(counter DRAM write_bursts 32 1024 2 0 0 0 gcc_trace.txt --dram --dram-queue-depth=1)"
+expect "--dram-timings rejects negative cycles" \
+       "$(./sim_cache 64 64 1 0 0 0 "$rows" --dram-timings=-1,17,17,39 | cut -d: -f1)" "Error"
+for option in --dram-queue-depth=4000000000 --dram-banks=1099511627776 --dram-channels=4294967296 --dram-clock=0 \
+              --dram-cycles-per-access=0 "--dram-rows=4G --dram-row-size=1G --dram-channels=64 --dram-banks=256"; do
+   expect "$option is rejected" "$(./sim_cache 64 64 1 0 0 0 "$rows" $option | cut -d: -f1)" "Error"
+done
+expect "DRAM settings are recorded in the configuration" \
+       "$(./sim_cache 64 64 1 0 0 0 "$rows" --dram --format=csv | grep -c '^config,,dram_')" "10"
+rm -f "$rows"
+
+#Design-space explorer: stack-distance results equal direct simulation, and a re-run reuses every recorded result
+work=$(mktemp -d)
+cp gcc_trace.txt "$work/trace.txt"
+cat > "$work/spec" <<EOF
+block_size    = 16, 32
+l1_size       = 1024
+l1_assoc      = 1..4
+vc_num_blocks = 0, 8
+l2_size       = 0, 16384
+l2_assoc      = 2..8
+EOF
+# explore_line <label>: print the value of one statistics line of an explorer run over the copied trace
+explore_line() {
+   ./explore "$work/spec" "$work/trace.txt" "$work/results.csv" | grep "^  $1:" | awk '{print $NF}'
+}
+explore_line "candidate configurations" > /dev/null
+while IFS=, read -r trace block l1_size l1_assoc vc l2_size l2_assoc recorded; do
+   expect "explorer row $block,$l1_size,$l1_assoc,$vc,$l2_size,$l2_assoc equals sim_cache" "$recorded" \
+          "$(./sim_cache $block $l1_size $l1_assoc $vc $l2_size $l2_assoc "$work/trace.txt" --format=csv |
+             awk -F, '/^counter,/ { c[$2 "," $3] = $6 }
+                      END { printf "%d,%d,%d,%d,%d,%d,%d,%d,%d\n", c["L1,reads"] + c["L1,writes"],
+                            c["L1,read_misses"] + c["L1,write_misses"], c["L1,swaps"], c["L1,write_backs"],
+                            c["L2,reads"], c["L2,read_misses"], c["L2,read_misses"] + c["L2,write_misses"],
+                            c["MEM,reads"] + c["MEM,writes"], c["MEM,read_bytes"] + c["MEM,write_bytes"] }')"
+done < <(grep -v '^#' "$work/results.csv")
+candidates=$(explore_line "candidate configurations")
+expect "an explorer re-run reuses every recorded result" "$(explore_line "reused from results file")" "$candidates"
+expect "an explorer re-run evaluates nothing" \
+       "$(explore_line "stack-distance passes"),$(explore_line "simulated individually")" "0,0"
+touch -d '2001-01-01' "$work/trace.txt"
+expect "a new trace modification time invalidates recorded results" "$(explore_line "reused from results file")" "0"
+rm -rf "$work"
+
+if [ $failures -ne 0 ]; then
+   echo "$failures check(s) failed"
+   exit 1
+fi
+echo "All feature checks passed"
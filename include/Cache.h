@@ -27,11 +27,15 @@
 #define CACHESIM_INCLUDE_CACHE_H
 
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <vector>
 #include <string>
 
 /**
- * Block contains one block of memory data. Blocks are held within a Set.
+ * Block contains one block of memory data. Blocks are held within a Set. In a sectored cache, the block carries one
+ * valid and one dirty bit per sector; valid/dirty then describe the tag and "any sector dirty", respectively. Unsectored
+ * blocks use only bit 0 of the sector masks.
  */
 struct Block {
    explicit Block(uint_fast32_t init_recency) {
@@ -39,11 +43,15 @@ struct Block {
      valid = false;
      recency = init_recency;
      dirty = false;
+     valid_sectors = 0;
+     dirty_sectors = 0;
    };
    uint_fast32_t tag;
    bool valid;
    uint_fast32_t recency;
    bool dirty;
+   uint32_t valid_sectors;
+   uint32_t dirty_sectors;
 
    // Implement comparator less-than based on recency of this and another given Block
    bool operator < (const Block i) const {
@@ -52,19 +60,119 @@ struct Block {
 };
 
 /**
- * Set contains a set of Blocks of memory.
+ * Set contains a set of Blocks of memory, kept in LRU order by their recencies. The same lookup and replacement
+ * machinery serves every set-associative structure in the simulator: cache levels, the victim cache and the TLBs.
  */
 struct Set{
    explicit Set(uint_fast32_t size) {
       for(size_t i =0; i< size; ++i){
          blocks.emplace_back(Block(i));
       }
+      mru_way = 0;
    };
    std::vector<Block> blocks;
+   uint_fast32_t mru_way; // Position in blocks of the most-recently-used block (recency 0)
+
+   // Find the valid block with the given tag, checking the most-recently-used way first. nullptr if absent.
+   inline Block *find(uint_fast32_t tag) {
+      Block &mru = blocks[mru_way];
+      if (mru.valid && mru.tag == tag)
+         return &mru;
+      for (Block &block : blocks)
+         if (block.valid && block.tag == tag)
+            return &block;
+      return nullptr;
+   }
+
+   // The least-recently-used block, replaced on a miss
+   inline Block &lru() {
+      for (Block &block : blocks)
+         if (block.recency == blocks.size() - 1)
+            return block;
+      return blocks.back();
+   }
+
+   /**
+    * Make the given block most recent (recency=0). The recency of older blocks stays the same, and the recency of newer
+    * blocks is incremented by 1.
+    */
+   inline void make_mru(Block &block) {
+      if (block.recency != 0) {
+         for (Block &traversal_block: blocks)
+            if (traversal_block < block)
+               ++traversal_block.recency;
+         block.recency = 0;
+      }
+      mru_way = &block - blocks.data();
+   }
 };
 
+// Modes of the L1's MRU-repeat filter: disabled, last accessed block only, or last block plus each set's MRU way.
+enum mru_filters{MRU_FILTER_OFF = 0, MRU_FILTER_LAST, MRU_FILTER_SET};
+
+// Upper bound on sectors per block, set by the width of the per-sector valid/dirty masks in Block.
+const unsigned long int MAX_SECTORS = 32;
+
+// Upper bound on the length of the miss profiler's top-K lists, keeping the profile small and its upkeep cheap.
+const unsigned long int MAX_PROFILE_TOP_K = 1024;
+
+// Upper bound on each DRAM timing given on the command line, in DRAM cycles (real parts need well under 100).
+const unsigned long int MAX_DRAM_TIMING = 1000;
+
+// Upper bounds on the DRAM organization, well above real systems, so that the per-bank state and queues stay small.
+const unsigned long int MAX_DRAM_CHANNELS = 64;
+const unsigned long int MAX_DRAM_RANKS = 16;
+const unsigned long int MAX_DRAM_BANKS = 256;
+const unsigned long int MAX_DRAM_QUEUE_DEPTH = 65536;
+
 /**
- * cache_params encapsulates the parameters used to construct the full memory hierarchy.
+ * tlb_params encapsulates the optional address translation in front of the L1: an L1 TLB, an optional L2 TLB, a
+ * single page size (4 KB, 2 MB or 1 GB), and the physical memory into which the deterministic mapper places pages.
+ * l1_entries of 0 disables translation, and trace addresses are then physical. An associativity of 0 means fully
+ * associative; physical_memory of 0 means 4 GB, and page_size of 0 means 4 KB. Physical memory must hold at least 64
+ * pages, so 1 GB pages need at least 64 GB.
+ */
+typedef struct tlb_params{
+   unsigned long int l1_entries;
+   unsigned long int l1_assoc;
+   unsigned long int l2_entries;
+   unsigned long int l2_assoc;
+   unsigned long int page_size;
+   uint_fast64_t physical_memory;
+   uint_fast64_t mapping_seed;
+} tlb_params;
+
+// Fields of a DRAM address, as named in address mappings ("Ro", "Ra", "Ba", "Ch", "Co").
+enum dram_fields{DRAM_ROW = 0, DRAM_RANK, DRAM_BANK, DRAM_CHANNEL, DRAM_COLUMN};
+
+/**
+ * dram_params encapsulates the optional DRAM timing model behind main memory. channels of 0 leaves main memory
+ * functional (the default). Other fields of 0 take DDR4-2400 style defaults: 1 rank, 16 banks, 65536 rows of 8 KB,
+ * 64-byte bursts, 32-entry read and write queues, the "RoRaBaChCo" mapping, a 1200 MHz clock, 1 DRAM cycle per CPU
+ * access, and timings (in DRAM cycles) of tCL=tRCD=tRP=17, tRAS=39, tCWL=12, tWR=18, a 4-cycle burst and a 2-cycle bus
+ * turnaround. Requests arrive open loop, one CPU access every cycles_per_access DRAM cycles, as the CPU never stalls on
+ * a miss; a miss-heavy trace at the default rate saturates the queues, and its read latency is mostly queueing.
+ */
+typedef struct dram_params{
+   unsigned long int channels;
+   unsigned long int ranks;
+   unsigned long int banks;
+   unsigned long int rows;
+   unsigned long int row_size;
+   unsigned long int burst_size;
+   unsigned long int queue_depth;
+   uint8_t mapping[5];             // dram_fields, most significant first
+   double clock_mhz;
+   double cycles_per_access;
+   unsigned long int t_cl, t_rcd, t_rp, t_ras, t_cwl, t_wr, t_burst, t_turnaround;
+} dram_params;
+
+/**
+ * cache_params encapsulates the parameters used to construct the full memory hierarchy. block_size applies to the L1
+ * and its victim cache; l2_block_size of 0 means "same as block_size". Sector counts of 0 or 1 mean unsectored.
+ * mru_filter selects the L1 fast path for repeat hits, which never changes results. tlb configures address translation
+ * in front of the L1. profile_top_k of more than 0 profiles the misses of every cache level, ranking that many pages and
+ * blocks. dram selects a DRAM timing model for main memory.
  */
 typedef struct cache_params{
    unsigned long int block_size;
@@ -73,11 +181,53 @@ typedef struct cache_params{
    unsigned long int vc_num_blocks;
    unsigned long int l2_size;
    unsigned long int l2_assoc;
+   unsigned long int l2_block_size;
+   unsigned long int l1_sectors;
+   unsigned long int l2_sectors;
+   mru_filters mru_filter;
+   tlb_params tlb;
+   unsigned long int profile_top_k;
+   dram_params dram;
 } cache_params;
 
+/**
+ * hierarchy_summary encapsulates the headline results of a simulation run, for callers that consume results
+ * programmatically rather than through the reports.
+ */
+typedef struct hierarchy_summary{
+   uint_fast64_t accesses;        // L1 reads + writes
+   uint_fast64_t l1_misses;       // L1 read + write misses, including those served by VC swaps
+   uint_fast64_t vc_swaps;
+   uint_fast64_t l1_write_backs;
+   uint_fast64_t l2_reads;        // All L2 fields are 0 without an L2
+   uint_fast64_t l2_read_misses;
+   uint_fast64_t l2_misses;       // L2 read + write misses
+   uint_fast64_t memory_requests;
+   uint_fast64_t memory_bytes;
+} hierarchy_summary;
+
+/**
+ * report_setting encapsulates one entry of the configuration recorded in structured reports: a setting name and its
+ * value as text. Numeric values are written bare in JSON, and other values as strings.
+ */
+typedef struct report_setting{
+   std::string name;
+   std::string value;
+   bool numeric;
+} report_setting;
+
 // Encapsulate human-readable reference for types/levels that a Cache memory can be.
 enum levels{L1 = 0x01, L2=0x02, VC=0xfe, MAIN_MEM=0xff};
 
+// Output formats for the end-of-run report
+enum report_formats{FORMAT_TEXT, FORMAT_JSON, FORMAT_CSV};
+
+class OutputWriter;
+class Tlb;
+class MissProfiler;
+class Dram;
+class StackDistance;
+
 class Cache {
 private:
    //Constants
@@ -85,12 +235,36 @@ private:
 
    // System-Level Vars
    bool main_memory;
-   uint_fast32_t reads, read_hits, read_misses, writes, write_hits, write_misses, vc_swaps, write_backs,
-   vc_swap_requests, index_length, block_length, block_size, local_assoc, level, local_size;
+   uint_fast32_t index_length, block_length, block_size, local_assoc, level, local_size;
 
-   // Pointers to the rest of the memory hierarchy
+   // Per-level access counters, 64-bit so that billion-access runs cannot wrap them
+   uint_fast64_t reads, read_hits, read_misses, writes, write_hits, write_misses, vc_swaps, write_backs, vc_swap_requests;
+
+   // Sectoring geometry (one sector spanning the whole block when unsectored)
+   uint_fast32_t sector_length, sector_size, sectors_per_block;
+
+   // Traffic received from the level above, in requests and in bytes, plus tag-hit/sector-miss count
+   uint_fast64_t read_requests, write_requests, read_bytes, write_bytes, sector_misses;
+
+   // MRU filter state: the last accessed block and its block number (address >> block_length), and the hit count
+   Block *mru_block;
+   unsigned long mru_block_number;
+   uint_fast64_t mru_filter_hits;
+
+   // Pointers to the rest of the memory hierarchy, and the TLB translating CPU accesses to the L1 (if any)
    Cache *next_level;
    Cache *victim_cache;
+   Tlb *tlb;
+
+   // Miss profiler for this level (if any)
+   MissProfiler *profiler;
+
+   // DRAM timing model behind main memory (if any), and the L1 whose access count times its requests
+   Dram *dram;
+   const Cache *cpu_level;
+
+   // Stack-distance analysis observing the requests that reach main memory (if any; not owned)
+   StackDistance *memory_analysis;
 
    // Hierarchy parameters, stored locally
    cache_params params;
@@ -98,16 +272,46 @@ private:
    // Encapsulate multiple Sets of Blocks for an n-way set-associative cache
    std::vector<Set> sets;
 
+   // Scratch space ordering one set's blocks by recency for reporting, reused across sets
+   std::vector<const Block *> recency_order;
+
+   // A named counter in structured reports
+   struct report_counter {
+      const char *name;
+      uint_fast64_t value;
+   };
+
    // Internal utility methods
-   inline void initialize_cache_sets();
-   static inline void update_set_recency(Set &set, Block &block);
+   inline void initialize_cache_sets(uint_fast32_t blocksize, uint_fast32_t sectors);
+   inline void reset_statistics();
    void extract_tag_index(uint_fast32_t *tag, uint_fast32_t *index, const uint_fast32_t *addr) const;
+   inline uint32_t sector_mask(const unsigned long &addr, uint_fast32_t bytes) const;
+   bool uniform_geometry() const;
+
+   // Per-block access handlers and the sector-granular transfers they issue to the next level
+   void read_block(const unsigned long &addr, uint_fast32_t bytes);
+   void write_block(const unsigned long &addr, uint_fast32_t bytes);
+   inline Block *mru_filter_lookup(const unsigned long &addr);
+   inline void make_mru(uint_fast32_t index, Block &block, const unsigned long &addr);
+   void fetch_sectors(Block *block, const unsigned long &base_addr, uint32_t wanted);
+   void write_back_sectors(Block *block, const unsigned long &base_addr);
 
    // Internal statistics/contents reporting methods
-   void cache_line_report(uint8_t set_num);
+   void contents_report(OutputWriter &out);
+   void cache_line_report(OutputWriter &out, size_t set_num);
+   void order_by_recency(const Set &set);
+   size_t hierarchy_levels(Cache **hierarchy);
+   const char *level_name() const;
+   size_t report_counters(report_counter *counters) const;
+   void configuration_settings(std::vector<report_setting> *settings) const;
    void L1_stats_report();
    void L2_stats_report();
-   void cat_padded(std::string *str, uint_fast32_t n);
+   void traffic_report();
+   void tlb_report();
+   void profile_report(OutputWriter &out);
+   void dram_report();
+   inline uint_fast64_t dram_arrival() const;
+   void cat_padded(std::string *str, uint_fast64_t n);
    void cat_padded(std::string *str, double n);
 
 
@@ -121,10 +325,21 @@ public:
    //Destructor
    ~Cache();
 
-   // CPU Interface read/write
+   // Each level owns the levels below it, so hierarchies are not copied
+   Cache(const Cache &) = delete;
+   Cache &operator=(const Cache &) = delete;
+
+   // CPU Interface read/write, translated by the TLB when one is configured
    void read(const unsigned long &addr);
    void write(const unsigned long &addr);
 
+   // Inter-level interface: a transfer of bytes starting at addr, split across this level's blocks
+   void read(const unsigned long &addr, uint_fast32_t bytes);
+   void write(const unsigned long &addr, uint_fast32_t bytes);
+
+   // Page-walk interface: a page-table entry read that is not counted as a CPU read (returns the misses it caused)
+   uint_fast64_t page_walk_read(const unsigned long &addr, uint_fast32_t bytes);
+
    //Victim Cache interface
    inline bool vc_has_block(const uint_fast32_t &addr);
    inline void vc_insert_block(Block *incoming_block, const unsigned long &sent_addr);
@@ -134,6 +349,14 @@ public:
    // Contents and Statistics reporting interfaces
    void contents_report();
    void statistics_report();
+   void structured_report(report_formats format, const std::vector<report_setting> &run_settings, bool include_contents);
+   void filter_report(FILE *stream) const;
+
+   // Headline results for programmatic consumers
+   hierarchy_summary summarize() const;
+
+   // Pass every request reaching main memory to a stack-distance analysis, measuring the level this hierarchy lacks
+   void analyze_memory_requests(StackDistance *analysis);
 
    // External string-manipulation with whitespace padding utility method
    static void cat_padded(std::string *head, std::string *cat);
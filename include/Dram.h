@@ -0,0 +1,127 @@
+/**
+ * Dram.h encapsulates headers for the Dram class, a timing model of DRAM main memory that can sit behind the main-memory
+ * level of the hierarchy. Without it, main memory is functional: it counts requests and bytes and always hits.
+ *
+ * The model divides memory into channels, ranks per channel, banks per rank, and rows per bank, and decodes physical
+ * addresses into those fields by a configurable mapping. Each memory request is split into bursts. Each burst is queued
+ * at its channel, which has separate read and write queues. Each channel schedules its queues FR-FCFS: the oldest
+ * request that hits an open row goes first, and otherwise the oldest request. Reads take priority over writes. Writes
+ * are drained in batches once the write queue passes a high watermark. Banks keep their row open after an access (open
+ * page policy), so later accesses see row hits, misses (bank closed) and conflicts (another row open). Command timing
+ * follows the usual DDR constraints (tCL, tCWL, tRCD, tRP, tRAS, tWR, burst length and bus turnaround); refresh and the
+ * activation-rate limits (tRRD, tFAW) are not modeled.
+ *
+ * The hierarchy has no clock of its own, so requests arrive at a time derived from the number of CPU accesses made so
+ * far. Each CPU access counts as cycles_per_access DRAM cycles.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_DRAM_H
+#define CACHESIM_INCLUDE_DRAM_H
+
+#include <cstdint>
+#include <vector>
+#include "Cache.h"
+
+/**
+ * dram_statistics encapsulates the counters of a timed run. Times are in DRAM cycles.
+ */
+typedef struct dram_statistics{
+   uint_fast64_t reads;            // Read bursts
+   uint_fast64_t writes;           // Write bursts
+   uint_fast64_t row_hits;
+   uint_fast64_t row_misses;       // Bank had no open row
+   uint_fast64_t row_conflicts;    // Bank had a different row open (bank conflict)
+   uint_fast64_t read_latency;     // Sum over reads of arrival-to-data-complete time
+   uint_fast64_t bus_busy;         // Sum over channels of data-bus cycles
+   uint_fast64_t elapsed;          // Completion time of the last burst
+   uint_fast64_t queue_full_stalls;
+   uint_fast64_t write_drains;
+} dram_statistics;
+
+class Dram {
+private:
+   /**
+    * A queued burst, with its decoded location, its arrival time, and the time from which it may be scheduled: its
+    * arrival, or later if it had to wait for a slot in a full queue. Read latency is measured from the arrival.
+    */
+   struct Request {
+      uint_fast64_t arrival;
+      uint_fast64_t ready;
+      uint_fast64_t row;
+      uint_fast32_t rank;
+      uint_fast32_t bank;
+      bool write;
+   };
+
+   /**
+    * Timing state of one bank: the open row, and the earliest times for its next column command and precharge.
+    */
+   struct Bank {
+      bool open;
+      uint_fast64_t row;
+      uint_fast64_t ready;
+      uint_fast64_t precharge_ready;
+   };
+
+   /**
+    * One channel: its queues, its banks (rank-major), and the state of its command scheduler and data bus.
+    */
+   struct Channel {
+      std::vector<Request> reads, writes;
+      std::vector<Bank> banks;
+      uint_fast64_t next_decision;
+      uint_fast64_t bus_free;
+      uint_fast32_t last_rank;
+      bool last_write;
+      bool bus_used;
+      bool draining_writes;
+   };
+
+   dram_params params;
+   std::vector<Channel> channels;
+
+   // Write queue occupancy that starts a write drain, and that ends it
+   size_t drain_high_watermark, drain_low_watermark;
+
+   // Address decoding: the bit position and width of each field, indexed by dram_fields
+   uint_fast32_t field_shift[5], field_length[5];
+
+   dram_statistics stats;
+
+   void enqueue(Channel &channel, const Request &request);
+   void issue(Channel &channel);
+   uint_fast64_t next_issue_time(const Channel &channel) const;
+   void decode(unsigned long addr, uint_fast32_t *channel, Request *request) const;
+
+public:
+   // Construct the model, which must have passed validate()
+   explicit Dram(const dram_params &params);
+
+   Dram(const Dram &) = delete;
+   Dram &operator=(const Dram &) = delete;
+
+   // Queue a transfer of bytes at addr, arriving at the given DRAM cycle (non-decreasing across calls)
+   void access(unsigned long addr, uint_fast32_t bytes, bool write, uint_fast64_t arrival);
+
+   // Complete every queued request (before reporting)
+   void drain();
+
+   // Whether the parameters describe a valid DRAM configuration (false with a message if not)
+   static bool validate(const dram_params &params, const char **error);
+
+   // Parse an address mapping such as "RoRaBaChCo" (fields most significant first). False if malformed.
+   static bool parse_mapping(const char *text, uint8_t *mapping);
+
+   // Format an address mapping (at least 11 characters)
+   static void format_mapping(const uint8_t *mapping, char *text);
+
+   // Configuration after defaults are applied, and counters of the run
+   const dram_params &configuration() const { return params; }
+   const dram_statistics &statistics() const { return stats; }
+};
+
+#endif //CACHESIM_INCLUDE_DRAM_H
@@ -0,0 +1,121 @@
+/**
+ * Explorer.h encapsulates headers for the Explorer class, which searches the cache hierarchy design space for a trace.
+ * Given ranges for each hierarchy parameter, per-structure area and latency costs, and an area and latency budget, the
+ * explorer enumerates every valid hierarchy, discards those over budget, evaluates the rest in parallel, and reports the
+ * Pareto frontier of miss rate and memory traffic (in bytes) against area.
+ *
+ * Hierarchies that differ only in the associativity of one LRU cache with a fixed set count (the L2; or the L1 when there
+ * is neither a VC nor an L2) form a family, and a family is evaluated in a single stack-distance pass rather than one
+ * simulation per member: by the LRU inclusion property, the depth of each reference in its set's recency stack gives the
+ * misses and write backs of that cache at every associativity at once (see StackDistance.h). An L2 family simulates
+ * its shared L1 (and VC) once, and measures the L2 on the requests the L1 sends to memory. Other hierarchies are
+ * simulated individually. Results are exact either way.
+ *
+ * Results are appended to a results file as they complete, and reloaded on the next run, so a re-run (or a run over an
+ * overlapping design space) only evaluates hierarchies it has not seen before. Rows are keyed by the trace's path, size
+ * and modification time, so results recorded for an edited trace are not reused.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_EXPLORER_H
+#define CACHESIM_INCLUDE_EXPLORER_H
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "Cache.h"
+
+/**
+ * structure_cost encapsulates one row of the cost table: the area and access latency of a cache structure as a function
+ * of its size and associativity.
+ *    area    = size_kb * area_per_kb + blocks * area_per_block
+ *    latency = latency + log2(size_kb) * latency_per_size_doubling + log2(assoc) * latency_per_assoc_doubling
+ */
+typedef struct structure_cost{
+   double area_per_kb;
+   double area_per_block;
+   double latency;
+   double latency_per_size_doubling;
+   double latency_per_assoc_doubling;
+} structure_cost;
+
+/**
+ * explore_point encapsulates one candidate hierarchy and, once evaluated, its results.
+ */
+typedef struct explore_point{
+   cache_params params;
+   double area;
+   double l1_latency;
+   bool evaluated;
+   bool from_results_file;
+   hierarchy_summary result;
+} explore_point;
+
+class Explorer {
+private:
+   // A unit of work: one stack-distance pass over a family, or one simulation of a single hierarchy
+   struct explore_job {
+      std::vector<size_t> members;   // Positions in points
+      bool stack_pass;
+   };
+
+   // Parameter ranges
+   std::vector<unsigned long int> block_sizes, l1_sizes, l1_assocs, vc_num_blocks, l2_sizes, l2_assocs;
+
+   // Cost table and budgets (a budget of 0 is unlimited)
+   structure_cost l1_cost, vc_cost, l2_cost, memory_cost;
+   double area_budget, latency_budget;
+   unsigned int threads;
+
+   // Trace identity and results cache
+   std::string trace_file, trace_id, results_file;
+   std::map<std::string, hierarchy_summary> known_results;
+
+   // Candidate hierarchies and search statistics
+   std::vector<explore_point> points;
+   size_t invalid_points, over_budget_points, cached_points, stack_points, stack_passes, simulated_points;
+
+   // Spec parsing
+   static bool parse_range(const std::string &text, std::vector<unsigned long int> *values);
+   static bool parse_cost(const std::string &text, structure_cost *cost);
+
+   // Cost model
+   static double structure_area(const structure_cost &cost, double bytes, double blocks);
+   static double structure_latency(const structure_cost &cost, double bytes, double assoc);
+
+   // Search
+   void enumerate();
+   void load_results();
+   void evaluate(const std::vector<explore_job> &jobs, std::string *error);
+   bool simulate(explore_point *point, std::string *error) const;
+   bool analyze_family(const std::vector<size_t> &members, std::string *error);
+   static std::string point_key(const cache_params &params);
+   void append_result(FILE *results, const explore_point &point) const;
+
+public:
+   // Metrics of an evaluated point
+   static double miss_rate(const explore_point &point);
+   double amat(const explore_point &point) const;
+   bool within_latency_budget(const explore_point &point) const;
+
+   Explorer();
+
+   // Read parameter ranges, cost table and budgets from a spec file
+   bool load_spec(const char *path, std::string *error);
+
+   // Select the trace to evaluate and the results file used to skip known configurations (recorded for the same trace
+   // path, size and modification time)
+   bool set_trace(const char *trace, const char *results, std::string *error);
+
+   // Run the search. False (with a message) if the trace cannot be simulated.
+   bool run(std::string *error);
+
+   // Report search statistics and the Pareto frontier to stdout
+   void report() const;
+};
+
+#endif //CACHESIM_INCLUDE_EXPLORER_H
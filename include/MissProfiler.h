@@ -0,0 +1,83 @@
+/**
+ * MissProfiler.h encapsulates headers for the MissProfiler class, which attributes the misses of one cache level to the
+ * pages and blocks that cause them, in fixed memory regardless of trace length or footprint.
+ *
+ * Each miss updates two heavy-hitter trackers (one keyed by page, one by block) and a HyperLogLog counter of distinct
+ * missing blocks. A heavy-hitter tracker is a count-min sketch with conservative update, which estimates the miss count
+ * of any key with an overestimate of at most about 0.1% of all misses, plus a table of the top-K keys by estimated count.
+ * The HyperLogLog estimates the number of distinct blocks to within about 2%; at the L1, where every block's first
+ * touch misses, this is the unique-block footprint of the workload.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_MISSPROFILER_H
+#define CACHESIM_INCLUDE_MISSPROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * hot_region encapsulates one entry of a top-K list: the first address of a page or block, and its estimated misses.
+ */
+typedef struct hot_region{
+   uint_fast64_t address;
+   uint_fast64_t misses;
+} hot_region;
+
+class MissProfiler {
+private:
+   // Count-min sketch geometry, and HyperLogLog precision (2^hll_precision one-byte registers)
+   static const size_t sketch_depth = 4;
+   static const size_t sketch_width = 2048;
+   static const uint_fast32_t hll_precision = 12;
+
+   /**
+    * HeavyHitters tracks the most frequent keys of a stream: a count-min sketch estimates every key's count, and the
+    * top table keeps the K keys with the highest estimates seen so far. The table is a min-heap on the estimates, so the
+    * key to replace is always at the root, and a key whose estimate does not beat the root is rejected in constant time.
+    */
+   struct HeavyHitters {
+      std::vector<uint_fast64_t> counters;   // sketch_depth rows of sketch_width counters
+      std::vector<hot_region> top;           // Keys (not addresses) and estimated counts, a min-heap on the counts
+      std::unordered_map<uint_fast64_t, size_t> positions;   // Position in top of each key it holds
+      size_t top_k;
+
+      void add(uint_fast64_t key);
+      void sift_down(size_t i);
+   };
+
+   HeavyHitters pages, blocks;
+   std::vector<uint8_t> registers;
+   uint_fast64_t misses;
+   uint_fast32_t block_length, page_length;
+
+   static inline uint_fast64_t hash(uint_fast64_t key);
+   static std::vector<hot_region> ranked(const HeavyHitters &tracker, uint_fast32_t length);
+
+public:
+   // Construct a profiler keeping the top_k pages and blocks, for a level with the given block and page sizes (log2)
+   MissProfiler(size_t top_k, uint_fast32_t block_length, uint_fast32_t page_length);
+
+   // Record a miss on the given address
+   void record_miss(const unsigned long &addr);
+
+   // Misses recorded
+   uint_fast64_t profiled_misses() const { return misses; }
+
+   // Estimated number of distinct blocks among the recorded misses
+   double unique_blocks() const;
+
+   // Block size at this level, in bytes
+   uint_fast64_t block_bytes() const { return (uint_fast64_t) 1 << block_length; }
+
+   // The top pages and blocks by estimated misses, most-missed first
+   std::vector<hot_region> top_pages() const { return ranked(pages, page_length); }
+   std::vector<hot_region> top_blocks() const { return ranked(blocks, block_length); }
+};
+
+#endif //CACHESIM_INCLUDE_MISSPROFILER_H
@@ -0,0 +1,72 @@
+/**
+ * OutputWriter.h encapsulates headers for the OutputWriter class, a buffered writer used for reporting. Text, integers
+ * and hex values are formatted directly into a fixed buffer that is flushed to the underlying stream only when full (or
+ * on request), so reports over caches with millions of sets neither allocate nor issue one stream write per line.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_OUTPUTWRITER_H
+#define CACHESIM_INCLUDE_OUTPUTWRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+class OutputWriter {
+private:
+   static const size_t buffer_size = 1 << 16;
+   char buffer[buffer_size];
+   size_t used;
+   FILE *stream;
+
+   // Ensure at least n bytes are free in the buffer
+   inline void reserve(size_t n) {
+      if (used + n > buffer_size)
+         flush();
+   }
+
+public:
+   // Write through to the given stdio stream (which is flushed along with the buffer)
+   explicit OutputWriter(FILE *stream);
+
+   //Destructor flushes any buffered output
+   ~OutputWriter();
+
+   OutputWriter(const OutputWriter &) = delete;
+   OutputWriter &operator=(const OutputWriter &) = delete;
+
+   // Hand buffered output to the stream
+   void flush();
+
+   // Raw text
+   inline OutputWriter &put(char c) {
+      reserve(1);
+      buffer[used++] = c;
+      return *this;
+   }
+   OutputWriter &put(const char *str, size_t n);
+   inline OutputWriter &put(const char *str) { return put(str, strlen(str)); }
+   inline OutputWriter &put(const std::string &str) { return put(str.data(), str.size()); }
+
+   // Repeat a character n times
+   OutputWriter &fill(char c, size_t n);
+
+   // Unsigned integers in decimal or lower-case hex, right-aligned in a field of at least width characters
+   OutputWriter &put_uint(uint_fast64_t n, size_t width = 0);
+   OutputWriter &put_hex(uint_fast64_t n, size_t width = 0);
+
+   // Doubles with a fixed number of decimal places
+   OutputWriter &put_fixed(double n, int decimals);
+
+   // A JSON string literal (quoted and escaped)
+   OutputWriter &put_json_string(const char *str);
+
+   // A CSV field, quoted only when it contains a separator, quote or line break
+   OutputWriter &put_csv_field(const char *str);
+};
+
+#endif //CACHESIM_INCLUDE_OUTPUTWRITER_H
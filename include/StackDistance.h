@@ -0,0 +1,72 @@
+/**
+ * StackDistance.h encapsulates headers for the StackDistance class, which measures one level of write-back,
+ * write-allocate LRU cache with a fixed number of sets at every associativity up to a maximum, in a single pass over its
+ * requests (Mattson et al., 1970). LRU has the inclusion property: with the same sets, an A-way cache always holds the
+ * A most recently used blocks of each set, so a reference to the block at depth d of its set's recency stack misses
+ * exactly in the caches of fewer than d ways. Recording the depth of every reference therefore gives the misses of all
+ * associativities at once.
+ *
+ * Write backs are counted per associativity from each block's dirty history. Once written, a block stays dirty in an
+ * A-way cache until it is evicted, and a re-fetch after eviction is clean, so after a write it is dirty in exactly the
+ * caches with at least as many ways as the deepest depth at which it has been referenced since. Each stack entry keeps
+ * that bound; when the block falls below depth A (or leaves the stack), the A-way caches that held it dirty write it back.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_STACKDISTANCE_H
+#define CACHESIM_INCLUDE_STACKDISTANCE_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * stack_counts encapsulates the counters of one associativity, as the simulator would report them for that level.
+ */
+typedef struct stack_counts{
+   uint_fast64_t reads;
+   uint_fast64_t read_misses;
+   uint_fast64_t writes;
+   uint_fast64_t write_misses;
+   uint_fast64_t write_backs;     // Dirty blocks evicted during the run (blocks still resident are not written back)
+} stack_counts;
+
+class StackDistance {
+private:
+   // One block of a recency stack: its block number, and the smallest associativity holding it dirty
+   struct Entry {
+      unsigned long block;
+      uint_fast32_t dirty_from;   // max_assoc + 1 when the block is clean at every associativity
+   };
+
+   uint_fast32_t block_length, set_mask, max_assoc;
+
+   // Recency stack of each set, most recently used first, at most max_assoc deep
+   std::vector<std::vector<Entry>> stacks;
+
+   // References by depth (1..max_assoc; max_assoc + 1 for deeper or cold), and write backs as a difference array over
+   // associativity: the write backs of an A-way cache are the sum of the first A + 1 entries
+   std::vector<uint_fast64_t> read_depths, write_depths, write_back_steps;
+
+   void reference(unsigned long block, bool write);
+   void count_write_backs(uint_fast32_t dirty_from, uint_fast32_t evicted_below);
+
+public:
+   // Measure a cache of the given number of sets and block size, at every associativity from 1 to max_assoc
+   StackDistance(uint_fast32_t num_sets, uint_fast32_t block_size, uint_fast32_t max_assoc);
+
+   // CPU interface, as for a Cache (a trace sink)
+   void read(const unsigned long &addr) { read(addr, 1); }
+   void write(const unsigned long &addr) { write(addr, 1); }
+
+   // Inter-level interface: a transfer of bytes starting at addr, split across the blocks it overlaps
+   void read(const unsigned long &addr, uint_fast32_t bytes);
+   void write(const unsigned long &addr, uint_fast32_t bytes);
+
+   // Counters of the cache with the given associativity (1..max_assoc) over the requests so far
+   stack_counts counts(uint_fast32_t assoc) const;
+};
+
+#endif //CACHESIM_INCLUDE_STACKDISTANCE_H
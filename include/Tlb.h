@@ -0,0 +1,127 @@
+/**
+ * Tlb.h encapsulates headers for the Tlb class, which translates the virtual addresses of CPU accesses to physical
+ * addresses in front of the L1 cache. It models an L1 TLB and an optional L2 TLB over a single page size (4 KB, 2 MB or
+ * 1 GB), a deterministic virtual-to-physical mapper, and an x86-64 style radix page table whose walks are issued as reads
+ * to the L1, so that page-table entries compete with data for cache capacity exactly as they do in hardware. Walk reads
+ * are counted by the TLB, not as L1 CPU reads, so the classic CPU statistics keep counting CPU accesses only.
+ *
+ * TLB entries are Blocks held in Sets, tagged by virtual page number, and are found and replaced with the same LRU set
+ * machinery as the cache levels. Repeat accesses to the last translated page skip the set search altogether, so
+ * enabling translation adds one comparison to the common case.
+ *
+ * The mapper assigns data frames in first-touch order, scattered across physical memory by a fixed bijection of the
+ * allocation sequence, so that contiguous virtual pages are not physically contiguous and every run is reproducible.
+ * Page-table nodes are allocated sequentially in a region directly above the data frames.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_TLB_H
+#define CACHESIM_INCLUDE_TLB_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Cache.h"
+
+/**
+ * tlb_statistics encapsulates the translation counters of a run.
+ */
+typedef struct tlb_statistics{
+   uint_fast64_t translations;
+   uint_fast64_t l1_misses;
+   uint_fast64_t l2_misses;       // 0 without an L2 TLB
+   uint_fast64_t walks;
+   uint_fast64_t walk_reads;      // Page-table entry reads issued to the L1 (not counted as L1 CPU reads)
+   uint_fast64_t walk_read_misses;   // Page-table entry reads that missed in the L1
+   uint_fast64_t pages_mapped;
+   uint_fast64_t page_tables;     // Page-table nodes allocated, including the root
+} tlb_statistics;
+
+class Tlb {
+private:
+   // Page-table geometry: 9 index bits per level over a 48-bit virtual address, 8-byte entries, 4 KB nodes
+   static const uint_fast32_t virtual_address_length = 48;
+   static const uint_fast32_t level_index_length = 9;
+   static const uint_fast32_t table_node_length = 12;
+   static const uint_fast32_t entry_size = 8;
+
+   // Fewest page frames physical memory may hold: with fewer, distinct pages soon share frames (and cache blocks)
+   static const uint_fast64_t min_physical_frames = 64;
+
+   /**
+    * One TLB level: Sets of entries tagged by virtual page number, and the physical frame each entry maps, stored by
+    * set * assoc + way.
+    */
+   struct TlbLevel {
+      std::vector<Set> sets;
+      std::vector<uint_fast64_t> frames;
+      uint_fast32_t index_length, assoc;
+   };
+
+   tlb_params params;
+   uint_fast32_t page_length;
+   uint_fast64_t offset_mask;
+   TlbLevel l1_tlb, l2_tlb;
+
+   // The last translated page and its frame (the MRU entry of the L1 TLB)
+   uint_fast64_t last_page, last_frame;
+
+   // Page walks are issued to this level (the L1)
+   Cache *walker;
+   uint_fast32_t walk_levels;
+
+   // Mapper state: data frames by virtual page, page-table nodes by (level, virtual address prefix)
+   std::unordered_map<uint_fast64_t, uint_fast64_t> page_frames;
+   std::unordered_map<uint_fast64_t, uint_fast64_t> table_nodes;
+   uint_fast64_t frame_mask, table_base;
+
+   tlb_statistics stats;
+
+   static void initialize_level(TlbLevel *tlb, unsigned long int entries, unsigned long int assoc);
+   static Block *lookup(TlbLevel &tlb, uint_fast64_t page, uint_fast64_t *frame);
+   static void fill(TlbLevel &tlb, uint_fast64_t page, uint_fast64_t frame);
+
+   uint_fast64_t translate_page(uint_fast64_t page);
+   uint_fast64_t walk(uint_fast64_t page);
+   uint_fast64_t page_frame(uint_fast64_t page);
+   uint_fast64_t table_node(uint_fast32_t level, uint_fast64_t prefix);
+
+public:
+   // Construct the TLBs and mapper, issuing page walks to the given level (the L1)
+   Tlb(const tlb_params &params, Cache *walker);
+
+   Tlb(const Tlb &) = delete;
+   Tlb &operator=(const Tlb &) = delete;
+
+   // Translate the virtual address of a CPU access to its physical address
+   inline unsigned long translate(const unsigned long &addr);
+
+   // Whether the parameters describe a valid TLB configuration (false with a message if not)
+   static bool validate(const tlb_params &params, const char **error);
+
+   // Configuration after defaults are applied, and counters of the run
+   const tlb_params &configuration() const { return params; }
+   const tlb_statistics &statistics() const { return stats; }
+};
+
+/**
+ * Translate the virtual address of a CPU access. A repeat access to the last translated page is an L1 TLB hit on the MRU
+ * entry of its set, and is retired without a set search.
+ *
+ * @param addr the virtual address requested by the CPU
+ * @return the physical address
+ */
+inline unsigned long Tlb::translate(const unsigned long &addr) {
+   ++stats.translations;
+   uint_fast64_t page = addr >> page_length;
+   if (page != last_page) {
+      last_frame = translate_page(page);
+      last_page = page;
+   }
+   return (last_frame << page_length) | (addr & offset_mask);
+}
+
+#endif //CACHESIM_INCLUDE_TLB_H
@@ -0,0 +1,278 @@
+/**
+ * TraceReader.h encapsulates headers for the TraceReader class, which parses a memory trace in the simulator's text
+ * format ("r <hex address>" or "w <hex address>", one access per line) and hands every access straight to a sink such as
+ * the L1 Cache.
+ *
+ * The trace is memory-mapped and scanned in place. When mapping is not possible (pipes, standard input), the trace is
+ * streamed through a fixed 1 MiB buffer instead, carrying each block's partial last line into the next, so memory stays
+ * bounded however long the stream. Line boundaries are located sixteen bytes at a time with SSE2 compares, and addresses
+ * are decoded through a lookup table rather than locale-aware stdio. No memory is allocated per line. Malformed lines
+ * stop the parse and are reported by line number to the caller; failed reads stop it and are reported by errno.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_TRACEREADER_H
+#define CACHESIM_INCLUDE_TRACEREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+class TraceReader {
+private:
+   // Size of the buffer a streamed trace is read through; no line may be longer
+   static const size_t stream_block = 1 << 20;
+
+   // Mapped trace contents (nullptr when streamed), and its length, or the bytes streamed by the most recent parse
+   const char *data;
+   size_t length;
+   bool mapped;
+
+   // Streamed trace: its descriptor, whether it can be rewound to parse again, and the fixed read buffer
+   int fd;
+   bool seekable;
+   bool consumed;
+   std::vector<char> buffer;
+
+   // Parse state and error reporting
+   bool opened;
+   uint_fast64_t lines;
+   uint_fast64_t records;
+   uint_fast64_t error_line;
+   int error_number;
+
+   // Hex digit values, with 0xff for non-hex characters
+   static const uint8_t hex_values[256];
+
+   template<typename Sink>
+   inline bool parse_line(const char *p, const char *end, Sink &sink);
+
+   template<typename Sink>
+   const char *parse_lines(const char *begin, const char *end, Sink &sink);
+
+   template<typename Sink>
+   bool parse_stream(Sink &sink);
+
+public:
+   // Open and map the given trace file (or prepare to stream it)
+   explicit TraceReader(const char *path);
+
+   //Destructor unmaps or closes the trace
+   ~TraceReader();
+
+   TraceReader(const TraceReader &) = delete;
+   TraceReader &operator=(const TraceReader &) = delete;
+
+   // Whether the trace could be opened and read
+   bool is_open() const { return opened; }
+
+   // Size of the trace, in bytes (for a streamed trace, the bytes read by the most recent parse)
+   size_t size() const { return length; }
+
+   // Whether the trace can be parsed more than once (false for a pipe that has already been read)
+   bool rewindable() const { return mapped || seekable || !consumed; }
+
+   // Number of lines consumed by the most recent parse
+   uint_fast64_t line_count() const { return lines; }
+
+   // Number of accesses delivered by the most recent parse
+   uint_fast64_t record_count() const { return records; }
+
+   // 1-based line number of the malformed line that stopped the most recent parse (0 if none)
+   uint_fast64_t malformed_line() const { return error_line; }
+
+   // errno of the failed read (or rewind) that stopped the most recent parse (0 if none)
+   int read_error() const { return error_number; }
+
+   // Parse the whole trace, calling sink.read(addr) / sink.write(addr) for each access. False on a malformed line or a
+   // failed read.
+   template<typename Sink>
+   bool parse(Sink &sink);
+};
+
+/**
+ * Parse one line of the trace and deliver it to the sink. Blank lines are skipped; otherwise the line must be an 'r' or
+ * 'w', whitespace, and a hex address (optionally 0x-prefixed) of at most 16 digits, followed only by whitespace.
+ *
+ * @param p first character of the line
+ * @param end one past the last character of the line, excluding the newline
+ * @param sink receiver of the decoded access
+ * @return true if the line was well-formed
+ */
+template<typename Sink>
+inline bool TraceReader::parse_line(const char *p, const char *end, Sink &sink) {
+   while (p < end && (*p == ' ' || *p == '\t'))
+      ++p;
+   while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+      --end;
+   if (p == end)
+      return true;
+
+   char rw = *p++;
+   if ((rw != 'r' && rw != 'w') || p == end || (*p != ' ' && *p != '\t'))
+      return false;
+   while (p < end && (*p == ' ' || *p == '\t'))
+      ++p;
+   if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+      p += 2;
+   if (p == end || end - p > 16)
+      return false;
+
+   unsigned long addr = 0;
+   for (; p < end; ++p) {
+      uint8_t digit = hex_values[(uint8_t) *p];
+      if (digit == 0xff)
+         return false;
+      addr = (addr << 4) | digit;
+   }
+
+   ++records;
+   if (rw == 'r')
+      sink.read(addr);
+   else
+      sink.write(addr);
+   return true;
+}
+
+/**
+ * Parse every complete (newline-terminated) line in a range, handing each access to the sink as soon as its line is
+ * decoded. Newlines are located sixteen bytes at a time where SSE2 is available.
+ *
+ * @param begin first character of the range, at the start of a line
+ * @param end one past the last character of the range
+ * @param sink receiver of the decoded accesses
+ * @return the start of the unterminated last line (end if there is none), or nullptr on a malformed line
+ */
+template<typename Sink>
+const char *TraceReader::parse_lines(const char *begin, const char *end, Sink &sink) {
+   const char *line = begin;
+   const char *p = begin;
+
+#if defined(__SSE2__)
+   const __m128i newline = _mm_set1_epi8('\n');
+   for (; p + 16 <= end; p += 16) {
+      unsigned int mask = (unsigned int) _mm_movemask_epi8(
+              _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), newline));
+      while (mask != 0) {
+         const char *eol = p + __builtin_ctz(mask);
+         mask &= mask - 1;
+         ++lines;
+         if (!parse_line(line, eol, sink)) {
+            error_line = lines;
+            return nullptr;
+         }
+         line = eol + 1;
+      }
+   }
+#endif
+
+   // Remaining tail (or the whole range without SSE2)
+   for (; p < end; ++p) {
+      if (*p != '\n')
+         continue;
+      ++lines;
+      if (!parse_line(line, p, sink)) {
+         error_line = lines;
+         return nullptr;
+      }
+      line = p + 1;
+   }
+   return line;
+}
+
+/**
+ * Parse a streamed trace block by block. Each block's partial last line is moved to the front of the buffer and
+ * completed by the next read, so the buffer never grows. A line that fills the whole buffer is malformed.
+ *
+ * @param sink receiver of the decoded accesses
+ * @return true if the whole stream was read and every line was well-formed; false if parsing stopped at
+ * malformed_line(), or at a failed read whose errno is read_error()
+ */
+template<typename Sink>
+bool TraceReader::parse_stream(Sink &sink) {
+   if (consumed && !seekable)
+      return true; // A pipe can only be read once
+   if (consumed && lseek(fd, 0, SEEK_SET) != 0) {
+      error_number = errno;
+      return false;
+   }
+   consumed = true;
+   buffer.resize(stream_block);
+   size_t carried = 0;
+   for (;;) {
+      ssize_t got = ::read(fd, buffer.data() + carried, stream_block - carried);
+      if (got < 0 && errno == EINTR)
+         continue;
+      if (got < 0) {
+         error_number = errno;
+         return false;
+      }
+      if (got == 0) {
+         // End of stream: the carried text is the final line, without a trailing newline
+         if (carried > 0) {
+            ++lines;
+            if (!parse_line(buffer.data(), buffer.data() + carried, sink)) {
+               error_line = lines;
+               return false;
+            }
+         }
+         return true;
+      }
+      length += (size_t) got;
+      const char *end = buffer.data() + carried + got;
+      const char *tail = parse_lines(buffer.data(), end, sink);
+      if (tail == nullptr)
+         return false;
+      carried = (size_t) (end - tail);
+      if (carried == stream_block) {
+         error_line = lines + 1;
+         return false;
+      }
+      memmove(buffer.data(), tail, carried);
+   }
+}
+
+/**
+ * Parse the whole trace, handing each access to the sink as soon as its line is decoded.
+ *
+ * @param sink receiver of the decoded accesses, providing read(const unsigned long &) and write(const unsigned long &)
+ * @return true if every line was well-formed, false if parsing stopped at malformed_line() or on read_error()
+ */
+template<typename Sink>
+bool TraceReader::parse(Sink &sink) {
+   lines = 0;
+   records = 0;
+   error_line = 0;
+   error_number = 0;
+   if (!mapped) {
+      length = 0;
+      return parse_stream(sink);
+   }
+
+   const char *end = data + length;
+   const char *line = parse_lines(data, end, sink);
+   if (line == nullptr)
+      return false;
+
+   // Final line without a trailing newline
+   if (line < end) {
+      ++lines;
+      if (!parse_line(line, end, sink)) {
+         error_line = lines;
+         return false;
+      }
+   }
+   return true;
+}
+
+#endif //CACHESIM_INCLUDE_TRACEREADER_H
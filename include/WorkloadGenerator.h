@@ -0,0 +1,153 @@
+/**
+ * WorkloadGenerator.h encapsulates headers for the WorkloadGenerator class, which synthesizes a memory access stream and
+ * hands every access straight to a sink such as the L1 Cache, in place of a trace file. This allows the hierarchy to be
+ * driven with billions of accesses, at any footprint, without touching the disk.
+ *
+ * Supported patterns are sequential streaming, fixed strides, uniform random, Zipfian hot sets, pointer chasing (a
+ * single pseudo-random cycle through every item) and cycling over a working set with a fixed reuse distance. Every
+ * pattern is deterministic for a given seed and uses constant memory regardless of footprint or length.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#ifndef CACHESIM_INCLUDE_WORKLOADGENERATOR_H
+#define CACHESIM_INCLUDE_WORKLOADGENERATOR_H
+
+#include <cstdint>
+
+// Encapsulate human-readable reference for the access patterns a workload can follow.
+enum workload_patterns{PATTERN_STREAM, PATTERN_STRIDE, PATTERN_RANDOM, PATTERN_ZIPF, PATTERN_CHASE, PATTERN_REUSE};
+
+/**
+ * workload_params encapsulates the parameters of a synthetic workload. The footprint is divided into items of stride
+ * bytes (rounded down to a power-of-two item count); streaming instead walks the footprint four bytes at a time. The
+ * stride must be a power of two: the command line rejects other strides, and the generator rounds them down.
+ */
+typedef struct workload_params{
+   workload_patterns pattern;
+   uint_fast64_t accesses;
+   uint_fast64_t footprint;
+   uint_fast64_t base_address;
+   uint_fast64_t stride;
+   uint_fast64_t reuse_distance;
+   double write_ratio;
+   double zipf_alpha;
+   uint_fast64_t seed;
+} workload_params;
+
+class WorkloadGenerator {
+private:
+   workload_params params;
+
+   // Item geometry: item_count is a power of two, item_mask = item_count - 1
+   uint_fast64_t item_count, item_mask, item_length, stream_limit;
+
+   // Per-access state
+   uint_fast64_t rng_state, position, write_threshold;
+
+   // Zipf rejection-inversion constants
+   double zipf_h_integral_x1, zipf_h_integral_n, zipf_s;
+
+   // Random number generation (splitmix64) and derived uniform doubles in [0, 1)
+   inline uint_fast64_t next_random();
+   inline double next_uniform() { return (double) (next_random() >> 11) * (1.0 / 9007199254740992.0); }
+
+   // Bijective scattering of an item number across the footprint
+   inline uint_fast64_t scatter(uint_fast64_t item) const {
+      return (item * 0x9e3779b97f4a7c15ULL + (params.seed | 1)) & item_mask;
+   }
+
+   // Zipf helpers
+   uint_fast64_t next_zipf_rank();
+   double zipf_h(double x) const;
+   double zipf_h_integral(double x) const;
+   double zipf_h_integral_inverse(double x) const;
+
+   inline unsigned long next_address();
+
+public:
+   // Construct a generator for the given workload
+   explicit WorkloadGenerator(const workload_params &params);
+
+   // Restart the access stream from the beginning (same seed, same sequence)
+   void reset();
+
+   // Generate the whole workload, calling sink.read(addr) / sink.write(addr) for each access
+   template<typename Sink>
+   void generate(Sink &sink);
+
+   // Parse a pattern name ("stream", "stride", "random", "zipf", "chase", "reuse"). False if unknown.
+   static bool parse_pattern(const char *name, workload_patterns *pattern);
+
+   // Name a pattern as parse_pattern accepts it
+   static const char *pattern_name(workload_patterns pattern);
+};
+
+/**
+ * Advance the splitmix64 generator.
+ *
+ * @return the next 64 pseudo-random bits
+ */
+inline uint_fast64_t WorkloadGenerator::next_random() {
+   uint_fast64_t z = (rng_state += 0x9e3779b97f4a7c15ULL);
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   return z ^ (z >> 31);
+}
+
+/**
+ * Calculate the address of the next access according to the workload pattern.
+ *
+ * @return the full-length address of the next access
+ */
+inline unsigned long WorkloadGenerator::next_address() {
+   uint_fast64_t item;
+   switch (params.pattern) {
+      case PATTERN_STREAM: {
+         uint_fast64_t offset = position;
+         position += 4;
+         if (position >= stream_limit)
+            position = 0;
+         return params.base_address + offset;
+      }
+      case PATTERN_STRIDE:
+         item = position++ & item_mask;
+         break;
+      case PATTERN_RANDOM:
+         item = next_random() & item_mask;
+         break;
+      case PATTERN_ZIPF:
+         item = scatter(next_zipf_rank() - 1);
+         break;
+      case PATTERN_CHASE:
+         // Full-period LCG modulo item_count: one dependent cycle through every item, in scattered order
+         position = (position * 6364136223846793005ULL + 1442695040888963407ULL) & item_mask;
+         item = position;
+         break;
+      default: // PATTERN_REUSE
+         item = scatter(position++ % params.reuse_distance);
+         break;
+   }
+   return params.base_address + (item << item_length);
+}
+
+/**
+ * Generate the whole workload, handing each access to the sink as soon as it is produced.
+ *
+ * @param sink receiver of the generated accesses, providing read(const unsigned long &) and
+ *             write(const unsigned long &)
+ */
+template<typename Sink>
+void WorkloadGenerator::generate(Sink &sink) {
+   for (uint_fast64_t i = 0; i < params.accesses; ++i) {
+      unsigned long addr = next_address();
+      if ((next_random() >> 11) < write_threshold)
+         sink.write(addr);
+      else
+         sink.read(addr);
+   }
+}
+
+#endif //CACHESIM_INCLUDE_WORKLOADGENERATOR_H
@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Explorer.h"
+
+int main (int argc, char* argv[])
+{
+    std::string error;      // Description of any failure
+    Explorer explorer;      // Design-space search
+
+    if(argc != 3 && argc != 4)  // Validate input parameter quantity
+    {
+        printf("Error: Expected inputs: <spec_file> <trace_file> [results_file] Given inputs:%d\n", argc-1);
+        exit(EXIT_FAILURE);
+    }
+
+    const char *spec_file    = argv[1];
+    const char *trace_file   = argv[2];
+    const char *results_file = argc == 4 ? argv[3] : "explore_results.csv";
+
+    if(strncmp(trace_file, "gen:", 4) == 0)
+    {
+        printf("Error: The explorer requires a trace file\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Read parameter ranges, costs and budgets, and check the trace
+    if(!explorer.load_spec(spec_file, &error) || !explorer.set_trace(trace_file, results_file, &error))
+    {
+        printf("Error: %s\n", error.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    // Search the design space and report the frontier
+    if(!explorer.run(&error))
+    {
+        printf("Error: %s\n", error.c_str());
+        exit(EXIT_FAILURE);
+    }
+    explorer.report();
+
+    return EXIT_SUCCESS;
+}
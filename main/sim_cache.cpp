@@ -1,19 +1,68 @@
+#include <cctype>
+#include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include "Cache.h"
+#include "Dram.h"
+#include "Tlb.h"
+#include "TraceReader.h"
+#include "WorkloadGenerator.h"
+
+/**
+ * run_options encapsulates command-line settings that control the simulator run rather than the hierarchy itself.
+ */
+typedef struct run_options{
+   bool parse_stats;
+   bool timing;
+   report_formats format;
+   bool contents;
+   workload_params workload;
+} run_options;
+
+/**
+ * ParseCounter is a trace sink that only tallies accesses, used to time the parser (or generator) on its own.
+ */
+struct ParseCounter {
+   uint_fast64_t reads = 0, writes = 0, checksum = 0;
+   void read(const unsigned long &addr) { ++reads; checksum ^= addr; }
+   void write(const unsigned long &addr) { ++writes; checksum ^= addr; }
+};
 
 void print_parameters_block(const char *trace_file, const cache_params &params);
+void workload_settings(const workload_params &workload, std::vector<report_setting> *settings);
+void print_parse_stats(TraceReader &reader, FILE *stream);
+void print_generator_stats(WorkloadGenerator &generator, FILE *stream);
+void print_run_timing(uint_fast64_t accesses, double seconds, FILE *stream);
+void print_filter_speedup(const cache_params &params, const run_options &options, TraceReader *reader, FILE *stream);
+double time_run(const cache_params &params, const run_options &options, TraceReader *reader);
+void parse_option(const char *option, cache_params *params, run_options *options);
+unsigned long int parse_geometry_value(const char *option, const char *value, bool power_of_two);
+uint_fast64_t parse_scaled_value(const char *option, const char *value, uint_fast64_t scale);
+double parse_real_value(const char *option, const char *value);
+double parse_positive_real_value(const char *option, const char *value);
+void parse_dram_timings(const char *option, const char *value, dram_params *dram);
 
 int main (int argc, char* argv[])
 {
-    FILE *FP;               // filepointer
     char *trace_file;       // Path to trace file
-    cache_params params;    // Parameters struct
-    char rw;                // 2-wide char array with r/w switch in position [0]
-    unsigned long int addr; // address
+    cache_params params = {};   // Parameters struct
+    run_options options = {};   // Run-control settings
+    params.mru_filter = MRU_FILTER_SET;
 
-    if(argc != 8)           // Validate input parameter quantity
+    // Synthetic workload defaults, used when trace_file is "gen:<pattern>"
+    options.workload.accesses       = 1000000;
+    options.workload.footprint      = 16 << 20;
+    options.workload.stride         = 64;
+    options.workload.reuse_distance = 1024;
+    options.workload.write_ratio    = 0.3;
+    options.workload.zipf_alpha     = 0.99;
+    options.workload.seed           = 1;
+
+    if(argc < 8)            // Validate input parameter quantity
     {
         printf("Error: Expected inputs:7 Given inputs:%d\n", argc-1);
         exit(EXIT_FAILURE);
@@ -27,35 +76,108 @@ int main (int argc, char* argv[])
     params.l2_assoc         = strtoul(argv[6], nullptr, 10);
     trace_file              = argv[7];
 
-    // Open trace_file in read mode
-    FP = fopen(trace_file, "r");
-    if(FP == nullptr)
+    // Optional --name=value settings follow the positional parameters
+    for (int i = 8; i < argc; ++i)
+        parse_option(argv[i], &params, &options);
+    if (params.l1_sectors > params.block_size ||
+        params.l2_sectors > (params.l2_block_size ? params.l2_block_size : params.block_size))
     {
-        // Throw error and exit if fopen() failed
-        printf("Error: Unable to open file %s\n", trace_file);
+        printf("Error: Sectors per block cannot exceed the block size\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *dram_error;
+    if(params.dram.channels > 0 && !Dram::validate(params.dram, &dram_error))
+    {
+        printf("Error: %s\n", dram_error);
+        exit(EXIT_FAILURE);
+    }
+    const tlb_params &tlb = params.tlb;
+    const char *tlb_error;
+    if((tlb.l1_entries || tlb.l1_assoc || tlb.l2_entries || tlb.l2_assoc || tlb.page_size || tlb.physical_memory ||
+        tlb.mapping_seed) && !Tlb::validate(tlb, &tlb_error))
+    {
+        printf("Error: %s\n", tlb_error);
         exit(EXIT_FAILURE);
     }
 
-    //Instantiate cache hierarchy
-    Cache L1 = Cache(params, 0x01);
-
-    // Print params
-   print_parameters_block(trace_file, params);
+    // A trace_file of the form "gen:<pattern>" selects the built-in workload generator instead of a trace on disk
+    bool synthetic = strncmp(trace_file, "gen:", 4) == 0;
+    if(synthetic && !WorkloadGenerator::parse_pattern(trace_file + 4, &options.workload.pattern))
+    {
+        printf("Error: Unknown workload pattern %s\n", trace_file + 4);
+        exit(EXIT_FAILURE);
+    }
 
-   char str[2];
-   // Parse tracefile; for each memory action, call read/write to memory hierarchy
-    while(fscanf(FP, "%s %lx", str, &addr) != EOF)
+    // Open and map trace_file
+    std::unique_ptr<TraceReader> reader;
+    if(!synthetic)
     {
-        rw = str[0];
-        if (rw == 'r')
-           L1.read(addr);
-        else if(rw == 'w')
-           L1.write(addr);
+        reader.reset(new TraceReader(trace_file));
+        if(!reader->is_open())
+        {
+            // Throw error and exit if the trace could not be opened
+            printf("Error: Unable to open file %s\n", trace_file);
+            exit(EXIT_FAILURE);
+        }
     }
 
+    //Instantiate cache hierarchy
+    Cache L1(params, 0x01);
+
+    // Print params (structured formats report them with the results instead)
+   if (options.format == FORMAT_TEXT)
+      print_parameters_block(trace_file, params);
+
+   // Parse tracefile (or generate the workload); for each memory action, call read/write to memory hierarchy
+   uint_fast64_t accesses;
+   auto start = std::chrono::steady_clock::now();
+   if(synthetic)
+   {
+      WorkloadGenerator generator(options.workload);
+      generator.generate(L1);
+      accesses = options.workload.accesses;
+   }
+   else
+   {
+      if(!reader->parse(L1))
+      {
+         if(reader->read_error())
+            printf("Error: Unable to read %s: %s\n", trace_file, strerror(reader->read_error()));
+         else
+            printf("Error: Malformed trace line %lu in %s\n", (unsigned long) reader->malformed_line(), trace_file);
+         exit(EXIT_FAILURE);
+      }
+      accesses = reader->record_count();
+   }
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
     // Report on simulation results and statistics (recursively calls self up the hierarchy)
-    L1.contents_report();
-    L1.statistics_report();
+    if (options.format == FORMAT_TEXT) {
+        L1.contents_report();
+        L1.statistics_report();
+    } else {
+        std::vector<report_setting> run_settings = {{"trace_file", trace_file, false}};
+        if (synthetic)
+            workload_settings(options.workload, &run_settings);
+        L1.structured_report(options.format, run_settings, options.contents);
+    }
+
+    // Timing reports go to stderr in structured formats, keeping stdout machine-readable
+    FILE *timing_stream = options.format == FORMAT_TEXT ? stdout : stderr;
+    if (options.parse_stats) {
+        if (synthetic) {
+            WorkloadGenerator generator(options.workload);
+            print_generator_stats(generator, timing_stream);
+        } else {
+            print_parse_stats(*reader, timing_stream);
+        }
+    }
+    if (options.timing) {
+        print_run_timing(accesses, elapsed.count(), timing_stream);
+        L1.filter_report(timing_stream);
+        if (params.mru_filter != MRU_FILTER_OFF)
+            print_filter_speedup(params, options, reader.get(), timing_stream);
+    }
 
     return EXIT_SUCCESS;
 }
@@ -86,6 +208,50 @@ void print_parameters_block(const char *trace_file, const cache_params &params)
    temp_string = std::to_string(params.l2_assoc);
    Cache::cat_padded(&params_string, &temp_string);
 
+   // Per-level geometry is only listed when it departs from a single, unsectored block size
+   if (params.l2_block_size != 0 && params.l2_block_size != params.block_size) {
+      params_string += "  L2_BLOCKSIZE: ";
+      temp_string = std::to_string(params.l2_block_size);
+      Cache::cat_padded(&params_string, &temp_string);
+   }
+
+   if (params.l1_sectors > 1) {
+      params_string += "  L1_SECTORS:   ";
+      temp_string = std::to_string(params.l1_sectors);
+      Cache::cat_padded(&params_string, &temp_string);
+   }
+
+   if (params.l2_sectors > 1) {
+      params_string += "  L2_SECTORS:   ";
+      temp_string = std::to_string(params.l2_sectors);
+      Cache::cat_padded(&params_string, &temp_string);
+   }
+
+   // Address translation is only listed when a TLB is configured
+   if (params.tlb.l1_entries > 0) {
+      params_string += "  TLB_ENTRIES:  ";
+      temp_string = std::to_string(params.tlb.l1_entries);
+      Cache::cat_padded(&params_string, &temp_string);
+
+      params_string += "  TLB_ASSOC:    ";
+      temp_string = std::to_string(params.tlb.l1_assoc ? params.tlb.l1_assoc : params.tlb.l1_entries);
+      Cache::cat_padded(&params_string, &temp_string);
+
+      if (params.tlb.l2_entries > 0) {
+         params_string += "  L2TLB_ENTRIES:";
+         temp_string = std::to_string(params.tlb.l2_entries);
+         Cache::cat_padded(&params_string, &temp_string);
+
+         params_string += "  L2TLB_ASSOC:  ";
+         temp_string = std::to_string(params.tlb.l2_assoc ? params.tlb.l2_assoc : params.tlb.l2_entries);
+         Cache::cat_padded(&params_string, &temp_string);
+      }
+
+      params_string += "  PAGE_SIZE:    ";
+      temp_string = std::to_string(params.tlb.page_size ? params.tlb.page_size : 4096);
+      Cache::cat_padded(&params_string, &temp_string);
+   }
+
    params_string += "  trace_file:   ";
    temp_string = trace_file;
    Cache::cat_padded(&params_string, &temp_string);
@@ -94,3 +260,407 @@ void print_parameters_block(const char *trace_file, const cache_params &params)
 
    std::cout << params_string;
 }
+
+/**
+ * Record the settings of a synthetic workload in the configuration of structured reports.
+ *
+ * @param workload the generated workload
+ * @param settings receives the settings
+ */
+void workload_settings(const workload_params &workload, std::vector<report_setting> *settings) {
+   char ratio[32], alpha[32];
+   snprintf(ratio, sizeof(ratio), "%g", workload.write_ratio);
+   snprintf(alpha, sizeof(alpha), "%g", workload.zipf_alpha);
+   settings->push_back({"workload_pattern", WorkloadGenerator::pattern_name(workload.pattern), false});
+   settings->push_back({"workload_accesses", std::to_string(workload.accesses), true});
+   settings->push_back({"workload_footprint", std::to_string(workload.footprint), true});
+   settings->push_back({"workload_base_address", std::to_string(workload.base_address), true});
+   settings->push_back({"workload_stride", std::to_string(workload.stride), true});
+   settings->push_back({"workload_reuse_distance", std::to_string(workload.reuse_distance), true});
+   settings->push_back({"workload_write_ratio", ratio, true});
+   settings->push_back({"workload_zipf_alpha", alpha, true});
+   settings->push_back({"workload_seed", std::to_string(workload.seed), true});
+}
+
+/**
+ * Apply one optional "--name=value" (or "--flag") command-line setting to the hierarchy parameters or run options.
+ * Exits on unknown or invalid settings.
+ *
+ * @param option the raw command-line argument
+ * @param params the parameters struct to update
+ * @param options the run-control settings to update
+ */
+void parse_option(const char *option, cache_params *params, run_options *options) {
+   if (strncmp(option, "--", 2) != 0) {
+      printf("Error: Unrecognized option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+   const char *value = strchr(option, '=');
+
+   // Flags without a value
+   if (value == nullptr) {
+      if (strcmp(option, "--parse-stats") == 0)
+         options->parse_stats = true;
+      else if (strcmp(option, "--contents") == 0)
+         options->contents = true;
+      else if (strcmp(option, "--timing") == 0)
+         options->timing = true;
+      else if (strcmp(option, "--profile") == 0)
+         params->profile_top_k = 10;
+      else if (strcmp(option, "--dram") == 0)
+         params->dram.channels = params->dram.channels ? params->dram.channels : 1;
+      else {
+         printf("Error: Unrecognized option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+      return;
+   }
+
+   std::string name(option + 2, value - option - 2);
+   ++value;
+
+   if (name == "l2-block-size")
+      params->l2_block_size = parse_geometry_value(option, value, true);
+   else if (name == "l1-sectors")
+      params->l1_sectors = parse_geometry_value(option, value, true);
+   else if (name == "l2-sectors")
+      params->l2_sectors = parse_geometry_value(option, value, true);
+   else if (name == "tlb-entries")
+      params->tlb.l1_entries = parse_geometry_value(option, value, false);
+   else if (name == "tlb-assoc")
+      params->tlb.l1_assoc = parse_geometry_value(option, value, false);
+   else if (name == "l2-tlb-entries")
+      params->tlb.l2_entries = parse_geometry_value(option, value, false);
+   else if (name == "l2-tlb-assoc")
+      params->tlb.l2_assoc = parse_geometry_value(option, value, false);
+   else if (name == "page-size")
+      params->tlb.page_size = parse_scaled_value(option, value, 1024);
+   else if (name == "physical-memory")
+      params->tlb.physical_memory = parse_scaled_value(option, value, 1024);
+   else if (name == "mapping-seed")
+      params->tlb.mapping_seed = parse_scaled_value(option, value, 1000);
+   else if (name == "profile-top")
+      params->profile_top_k = parse_geometry_value(option, value, false);
+   else if (name.compare(0, 5, "dram-") == 0) {
+      // Any DRAM setting enables the DRAM model (with one channel unless given)
+      if (name == "dram-channels")
+         params->dram.channels = parse_geometry_value(option, value, true);
+      else if (name == "dram-ranks")
+         params->dram.ranks = parse_geometry_value(option, value, true);
+      else if (name == "dram-banks")
+         params->dram.banks = parse_geometry_value(option, value, true);
+      else if (name == "dram-rows")
+         params->dram.rows = parse_scaled_value(option, value, 1024);
+      else if (name == "dram-row-size")
+         params->dram.row_size = parse_scaled_value(option, value, 1024);
+      else if (name == "dram-queue-depth")
+         params->dram.queue_depth = parse_geometry_value(option, value, false);
+      else if (name == "dram-clock")
+         params->dram.clock_mhz = parse_positive_real_value(option, value);
+      else if (name == "dram-cycles-per-access")
+         params->dram.cycles_per_access = parse_positive_real_value(option, value);
+      else if (name == "dram-mapping") {
+         if (!Dram::parse_mapping(value, params->dram.mapping)) {
+            printf("Error: Invalid value in option %s\n", option);
+            exit(EXIT_FAILURE);
+         }
+      }
+      else if (name == "dram-timings") {
+         parse_dram_timings(option, value, &params->dram);
+      }
+      else {
+         printf("Error: Unrecognized option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+      if (params->dram.channels == 0)
+         params->dram.channels = 1;
+   }
+   else if (name == "format") {
+      if (strcmp(value, "text") == 0)
+         options->format = FORMAT_TEXT;
+      else if (strcmp(value, "json") == 0)
+         options->format = FORMAT_JSON;
+      else if (strcmp(value, "csv") == 0)
+         options->format = FORMAT_CSV;
+      else {
+         printf("Error: Invalid value in option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+   }
+   else if (name == "mru-filter") {
+      if (strcmp(value, "off") == 0)
+         params->mru_filter = MRU_FILTER_OFF;
+      else if (strcmp(value, "last") == 0)
+         params->mru_filter = MRU_FILTER_LAST;
+      else if (strcmp(value, "set") == 0)
+         params->mru_filter = MRU_FILTER_SET;
+      else {
+         printf("Error: Invalid value in option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+   }
+   else if (name == "accesses")
+      options->workload.accesses = parse_scaled_value(option, value, 1000);
+   else if (name == "footprint")
+      options->workload.footprint = parse_scaled_value(option, value, 1024);
+   else if (name == "base-address")
+      options->workload.base_address = parse_scaled_value(option, value, 1024);
+   else if (name == "stride") {
+      options->workload.stride = parse_scaled_value(option, value, 1024);
+      if (options->workload.stride == 0 || (options->workload.stride & (options->workload.stride - 1)) != 0) {
+         printf("Error: Stride must be a power of two in option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+   }
+   else if (name == "reuse-distance")
+      options->workload.reuse_distance = parse_scaled_value(option, value, 1000);
+   else if (name == "seed")
+      options->workload.seed = parse_scaled_value(option, value, 1000);
+   else if (name == "write-ratio")
+      options->workload.write_ratio = parse_real_value(option, value);
+   else if (name == "zipf-alpha")
+      options->workload.zipf_alpha = parse_real_value(option, value);
+   else {
+      printf("Error: Unrecognized option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+
+   if (params->l1_sectors > MAX_SECTORS || params->l2_sectors > MAX_SECTORS) {
+      printf("Error: At most %lu sectors per block are supported\n", MAX_SECTORS);
+      exit(EXIT_FAILURE);
+   }
+   if (params->profile_top_k > MAX_PROFILE_TOP_K) {
+      printf("Error: At most %lu profiled pages and blocks are supported\n", MAX_PROFILE_TOP_K);
+      exit(EXIT_FAILURE);
+   }
+}
+
+/**
+ * Parse the numeric value of a geometry option, exiting if it is malformed, zero, or (where required) not a power of
+ * two.
+ *
+ * @param option the raw command-line argument, for error messages
+ * @param value the text following the '='
+ * @param power_of_two whether the value must be a power of two
+ * @return the parsed value
+ */
+unsigned long int parse_geometry_value(const char *option, const char *value, bool power_of_two) {
+   char *end;
+   unsigned long int n = strtoul(value, &end, 10);
+   if (*value == '\0' || *end != '\0' || n == 0 || (power_of_two && (n & (n - 1)) != 0)) {
+      printf("Error: Invalid value in option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+   return n;
+}
+
+/**
+ * Time a parse of the whole trace into a counting sink, isolating the parser from the hierarchy, and report its
+ * throughput.
+ *
+ * @param reader the opened trace
+ * @param stream where to write the report
+ */
+void print_parse_stats(TraceReader &reader, FILE *stream) {
+   // A pipe was consumed by the run itself and cannot be parsed again
+   if (!reader.rewindable()) {
+      fprintf(stream, "===== Trace parser =====\n");
+      fprintf(stream, "  trace was streamed from a pipe; parse timing unavailable\n");
+      return;
+   }
+
+   ParseCounter counter;
+   auto start = std::chrono::steady_clock::now();
+   reader.parse(counter);
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+   // Keep the decoded addresses observable so the timed loop cannot be optimized away
+   volatile uint_fast64_t checksum = counter.checksum;
+   (void) checksum;
+
+   double megabytes = (double) reader.size() / 1e6;
+   fprintf(stream, "===== Trace parser =====\n");
+   fprintf(stream, "  trace size (MB):                      %12.3f\n", megabytes);
+   fprintf(stream, "  accesses parsed:                      %12lu\n", (unsigned long) (counter.reads + counter.writes));
+   fprintf(stream, "  parse time (ms):                      %12.3f\n", elapsed.count() * 1e3);
+   fprintf(stream, "  parse throughput (MB/s):              %12.1f\n", elapsed.count() > 0 ? megabytes / elapsed.count() : 0.0);
+}
+
+/**
+ * Parse a count or size, accepting decimal or 0x-prefixed hex and an optional k/M/G suffix (multiplied by powers of
+ * scale), exiting if it is malformed or does not fit in 64 bits.
+ *
+ * @param option the raw command-line argument, for error messages
+ * @param value the text following the '='
+ * @param scale 1000 for counts, 1024 for byte sizes
+ * @return the parsed value
+ */
+uint_fast64_t parse_scaled_value(const char *option, const char *value, uint_fast64_t scale) {
+   char *end;
+   errno = 0;
+   uint_fast64_t n = strtoull(value, &end, 0);
+   bool overflow = errno == ERANGE;
+   if (end != value && *end != '\0' && end[1] == '\0') {
+      uint_fast64_t multiplier = 0;
+      switch (*end) {
+         case 'k': case 'K': multiplier = scale; break;
+         case 'm': case 'M': multiplier = scale * scale; break;
+         case 'g': case 'G': multiplier = scale * scale * scale; break;
+         default: break;
+      }
+      if (multiplier) {
+         overflow = overflow || n > UINT64_MAX / multiplier;
+         n *= multiplier;
+         ++end;
+      }
+   }
+   if (*value == '\0' || *value == '-' || *end != '\0' || overflow) {
+      printf("Error: Invalid value in option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+   return n;
+}
+
+/**
+ * Parse a non-negative real number, exiting if it is malformed.
+ *
+ * @param option the raw command-line argument, for error messages
+ * @param value the text following the '='
+ * @return the parsed value
+ */
+double parse_real_value(const char *option, const char *value) {
+   char *end;
+   double n = strtod(value, &end);
+   if (*value == '\0' || *end != '\0' || !(n >= 0)) {
+      printf("Error: Invalid value in option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+   return n;
+}
+
+/**
+ * Parse a positive real number, exiting if it is malformed or zero (for settings where 0 would otherwise select the
+ * default).
+ *
+ * @param option the raw command-line argument, for error messages
+ * @param value the text following the '='
+ * @return the parsed value
+ */
+double parse_positive_real_value(const char *option, const char *value) {
+   double n = parse_real_value(option, value);
+   if (n == 0) {
+      printf("Error: Invalid value in option %s\n", option);
+      exit(EXIT_FAILURE);
+   }
+   return n;
+}
+
+/**
+ * Parse the tCL,tRCD,tRP,tRAS list of --dram-timings, exiting unless it is exactly four comma-separated whole numbers of
+ * DRAM cycles, each from 1 to MAX_DRAM_TIMING.
+ *
+ * @param option the raw command-line argument, for error messages
+ * @param value the text following the '='
+ * @param dram the DRAM parameters receiving the timings
+ */
+void parse_dram_timings(const char *option, const char *value, dram_params *dram) {
+   unsigned long int *timings[] = {&dram->t_cl, &dram->t_rcd, &dram->t_rp, &dram->t_ras};
+   const char *p = value;
+   for (size_t i = 0; i < 4; ++i) {
+      char *end = nullptr;
+      errno = 0;
+      unsigned long int n = isdigit((unsigned char) *p) ? strtoul(p, &end, 10) : 0;
+      if (n == 0 || errno == ERANGE || n > MAX_DRAM_TIMING || *end != (i < 3 ? ',' : '\0')) {
+         printf("Error: Invalid value in option %s\n", option);
+         exit(EXIT_FAILURE);
+      }
+      *timings[i] = n;
+      p = end + 1;
+   }
+}
+
+/**
+ * Time generation of the whole workload into a counting sink, isolating the generator from the hierarchy, and report
+ * its throughput.
+ *
+ * @param generator the configured workload generator
+ * @param stream where to write the report
+ */
+void print_generator_stats(WorkloadGenerator &generator, FILE *stream) {
+   ParseCounter counter;
+   auto start = std::chrono::steady_clock::now();
+   generator.generate(counter);
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+   // Keep the generated addresses observable so the timed loop cannot be optimized away
+   volatile uint_fast64_t checksum = counter.checksum;
+   (void) checksum;
+
+   uint_fast64_t generated = counter.reads + counter.writes;
+   fprintf(stream, "===== Workload generator =====\n");
+   fprintf(stream, "  accesses generated:                   %12lu\n", (unsigned long) generated);
+   fprintf(stream, "  writes generated:                     %12lu\n", (unsigned long) counter.writes);
+   fprintf(stream, "  generation time (ms):                 %12.3f\n", elapsed.count() * 1e3);
+   fprintf(stream, "  generation throughput (M/s):          %12.1f\n",
+           elapsed.count() > 0 ? (double) generated / elapsed.count() / 1e6 : 0.0);
+}
+
+/**
+ * Report the wall time and throughput of the simulation run (trace parsing or workload generation included).
+ *
+ * @param accesses the number of accesses simulated
+ * @param seconds the wall time of the run
+ * @param stream where to write the report
+ */
+void print_run_timing(uint_fast64_t accesses, double seconds, FILE *stream) {
+   fprintf(stream, "===== Run timing =====\n");
+   fprintf(stream, "  accesses simulated:                   %12lu\n", (unsigned long) accesses);
+   fprintf(stream, "  simulation time (ms):                 %12.3f\n", seconds * 1e3);
+   fprintf(stream, "  simulation throughput (M/s):          %12.3f\n",
+           seconds > 0 ? (double) accesses / seconds / 1e6 : 0.0);
+}
+
+/**
+ * Measure the speedup of the MRU filter: re-run the workload on fresh hierarchies with the filter off and in the
+ * configured mode, and report both wall times. The main run has already warmed the trace into memory, so neither
+ * re-run pays for first-touch page faults.
+ *
+ * @param params the hierarchy, with the filter enabled
+ * @param options the run settings, giving the workload
+ * @param reader the opened trace (nullptr for a synthetic workload)
+ * @param stream where to write the report
+ */
+void print_filter_speedup(const cache_params &params, const run_options &options, TraceReader *reader, FILE *stream) {
+   if (reader && !reader->rewindable()) {
+      fprintf(stream, "  trace was streamed from a pipe; filter speedup unavailable\n");
+      return;
+   }
+   cache_params unfiltered = params;
+   unfiltered.mru_filter = MRU_FILTER_OFF;
+   double off_seconds = time_run(unfiltered, options, reader);
+   double on_seconds = time_run(params, options, reader);
+   fprintf(stream, "  re-run time, filter off (ms):         %12.3f\n", off_seconds * 1e3);
+   fprintf(stream, "  re-run time, filter on (ms):          %12.3f\n", on_seconds * 1e3);
+   fprintf(stream, "  filter speedup:                       %12.3f\n", on_seconds > 0 ? off_seconds / on_seconds : 0.0);
+}
+
+/**
+ * Time one run of the workload through a fresh hierarchy, including trace parsing or workload generation.
+ *
+ * @param params the hierarchy
+ * @param options the run settings, giving the workload
+ * @param reader the opened trace (nullptr for a synthetic workload)
+ * @return the wall time, in seconds
+ */
+double time_run(const cache_params &params, const run_options &options, TraceReader *reader) {
+   Cache hierarchy(params, L1);
+   auto start = std::chrono::steady_clock::now();
+   if (reader) {
+      reader->parse(hierarchy);
+   } else {
+      WorkloadGenerator generator(options.workload);
+      generator.generate(hierarchy);
+   }
+   std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+   return elapsed.count();
+}
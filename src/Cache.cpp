@@ -24,10 +24,14 @@
  */
 
 #include "Cache.h"
+#include "Dram.h"
+#include "MissProfiler.h"
+#include "OutputWriter.h"
+#include "StackDistance.h"
+#include "Tlb.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
-#include <sstream>
 
 /*************************************** CONSTRUCTION, INITIALIZATION, DESTRUCTION ***********************************/
 
@@ -39,42 +43,81 @@
  * @param level of this cache (Eg, 1, 2, 0xff (main memory))
  */
 Cache::Cache(cache_params params, uint8_t level) {
+   // Resolve defaulted per-level geometry: unset L2 block size follows the L1, unset sector counts mean unsectored.
+   if (params.l2_block_size == 0)
+      params.l2_block_size = params.block_size;
+   if (params.l1_sectors == 0)
+      params.l1_sectors = 1;
+   if (params.l2_sectors == 0)
+      params.l2_sectors = 1;
+
    // Initialize parameters and control switches
    this->params = params;
    this->level = level;
    this->main_memory = false;
+   next_level = nullptr;
+   victim_cache = nullptr;
+   tlb = nullptr;
+   profiler = nullptr;
+   dram = nullptr;
+   cpu_level = nullptr;
+   memory_analysis = nullptr;
 
    // Initialize statistics counters
-   reads = 0, read_misses = 0, read_hits = 0, writes = 0, write_misses = 0, write_hits = 0, vc_swaps = 0,
-      write_backs = 0, vc_swap_requests = 0;
+   reset_statistics();
 
    // Based on level parameter, instantiate this cache as an L1, an L2, or a main memory
    switch (level) {
       case MAIN_MEM: // This is a main  memory
          this->main_memory = true;
          victim_cache = nullptr;
+         if (params.dram.channels > 0)
+            dram = new Dram(params.dram);
          return;
       case L1: // This is an L1 cache
          local_size = params.l1_size;
          local_assoc = params.l1_assoc;
-         initialize_cache_sets();
+         initialize_cache_sets(params.block_size, params.l1_sectors);
 
          // If we parameters indicate we are adding a victim cache (size>0), instantiate a victim cache,
          // otherwise, set victim_cache ptr to null.
          params.vc_num_blocks > 0 ? victim_cache = new Cache(params.vc_num_blocks, params.block_size) :
                  victim_cache = nullptr;
 
+         // Translate CPU accesses through a TLB when one is configured; its page walks read through this level
+         if (params.tlb.l1_entries > 0)
+            tlb = new Tlb(params.tlb, this);
+
+         // Profile the misses of this level and its victim cache, over pages of the translation page size if any
+         if (params.profile_top_k > 0) {
+            uint_fast32_t page_length = log2(params.tlb.l1_entries && params.tlb.page_size ? params.tlb.page_size : 4096);
+            profiler = new MissProfiler(params.profile_top_k, block_length, page_length);
+            if (victim_cache)
+               victim_cache->profiler = new MissProfiler(params.profile_top_k, block_length, page_length);
+         }
+
          // Increment level and recursively instantiate either a next-level cache or a main memory
          ++level;
          if (params.l2_size == 0)
             level = MAIN_MEM; // There is no L2 cache so the next level is Main Memory
          next_level = new Cache(params, level);
+
+         // A DRAM model behind main memory times its requests by the number of CPU accesses made to this level
+         if (params.dram.channels > 0) {
+            Cache *memory = next_level;
+            while (!memory->main_memory)
+               memory = memory->next_level;
+            memory->cpu_level = this;
+         }
          return;
       case L2: // This is an L2 cache
          local_size = params.l2_size;
          local_assoc = params.l2_assoc;
          victim_cache = nullptr;
-         initialize_cache_sets();
+         initialize_cache_sets(params.l2_block_size, params.l2_sectors);
+         if (params.profile_top_k > 0)
+            profiler = new MissProfiler(params.profile_top_k, block_length,
+                                        log2(params.tlb.l1_entries && params.tlb.page_size ? params.tlb.page_size : 4096));
 
          // Recursively instantiate a main memory at the next-level
          level = MAIN_MEM;
@@ -91,134 +134,290 @@ Cache::Cache(cache_params params, uint8_t level) {
  */
 Cache::Cache(uint_fast32_t num_blocks, uint_fast32_t blocksize) {
    // Initialize parameters and control switches
+   this->params = cache_params();
    this->level = VC;
    this->main_memory = false;
+   next_level = nullptr;
+   victim_cache = nullptr;
+   tlb = nullptr;
+   profiler = nullptr;
+   dram = nullptr;
+   cpu_level = nullptr;
+   memory_analysis = nullptr;
 
    // Initialize statistics counters
-   reads = 0, read_misses = 0, read_hits = 0, writes = 0, write_misses = 0, write_hits = 0, vc_swaps = 0, write_backs = 0, vc_swap_requests = 0;
+   reset_statistics();
 
-   // Create the fully-associative victim cache
+   // Create the fully-associative victim cache. Sector masks of swapped blocks are carried through untouched.
    block_size=blocksize;
    local_assoc = num_blocks;
    sets.emplace_back(Set(local_assoc));
    index_length = 0; // Fully-associative
    block_length = log2(block_size);
+   sectors_per_block = 1;
+   sector_size = block_size;
+   sector_length = block_length;
 }
 
 /**
- * Initialize each set within (this) cache object based on the local size and local associativity.
+ * Initialize each set within (this) cache object based on the local size, local associativity and this level's block
+ * geometry.
+ *
+ * @param blocksize the size of each block at this level, in bytes
+ * @param sectors the number of independently valid/dirty sectors in each block (1 for an unsectored cache)
  */
-inline void Cache::initialize_cache_sets() {
-   block_size = (uint8_t) params.block_size;
+inline void Cache::initialize_cache_sets(uint_fast32_t blocksize, uint_fast32_t sectors) {
+   block_size = blocksize;
    size_t qty_sets = local_size / (local_assoc * block_size);
    for (size_t i = 0; i < qty_sets; ++i) {
       sets.emplace_back(Set(local_assoc));
    }
    index_length = log2(qty_sets);
    block_length = log2(block_size);
+   sectors_per_block = sectors;
+   sector_size = block_size / sectors_per_block;
+   sector_length = log2(sector_size);
 }
 
 /**
- * Stub destructor. Utilize C++11 garbage collection functionality to handle free()s when objects fall out of scope.
+ * Zero every statistics and traffic counter for this level.
  */
-Cache::~Cache() = default;
+inline void Cache::reset_statistics() {
+   reads = 0, read_misses = 0, read_hits = 0, writes = 0, write_misses = 0, write_hits = 0, vc_swaps = 0,
+      write_backs = 0, vc_swap_requests = 0;
+   read_requests = 0, write_requests = 0, read_bytes = 0, write_bytes = 0, sector_misses = 0, mru_filter_hits = 0;
+   mru_block = nullptr;
+   mru_block_number = 0;
+}
+
+/**
+ * Destructor. Recursively frees the DRAM model, the profiler, the TLB, the victim cache and the levels below this one, so that hierarchies can be built and
+ * torn down repeatedly (e.g. by the design-space explorer) without leaking.
+ */
+Cache::~Cache() {
+   delete dram;
+   delete profiler;
+   delete tlb;
+   delete victim_cache;
+   delete next_level;
+}
 
 
 /******************************************* MAIN I/O INTERFACE ******************************************************/
 
 /**
- * READS: Main IO interface for reads to this level of the memory hierarchy. Recursively reads/writes back on cache
- * misses and local evictions to the next level down the hierarchy.If a victim cache exists at this level, utilizes the
- * victim cache in the case of a miss.
+ * READS: Main IO interface for CPU reads to this level of the memory hierarchy. A CPU access touches a single sector
+ * of a single block. With a TLB, the address is virtual and is translated first (page walks read through this level).
+ * Repeat hits on the most-recently-used block are retired by the MRU filter without a set search.
  *
- * @param addr the address in memory requested by the caller (CPU or higher-level of hierarchy).
+ * @param addr the address in memory requested by the CPU.
  */
 void Cache::read(const unsigned long &addr) {
+   const unsigned long physical_addr = tlb ? tlb->translate(addr) : addr;
+
+   // Repeat hit on the most-recently-used block: only the counters change
+   if (mru_filter_lookup(physical_addr)) {
+      ++reads;
+      ++read_hits;
+      ++read_requests;
+      ++read_bytes;
+      return;
+   }
+   read(physical_addr, 1);
+}
+
+/**
+ * READS: Inter-level interface for a read (fill) request of a given length. The request is split across every block of
+ * this level that it overlaps, so that a level with smaller blocks than its requester services a fill as several block
+ * reads, and a level with larger blocks services it as one.
+ *
+ * @param addr the first address of the transfer requested by the caller (CPU or higher-level of hierarchy).
+ * @param bytes the length of the transfer, in bytes.
+ */
+void Cache::read(const unsigned long &addr, uint_fast32_t bytes) {
+   ++read_requests;
+   read_bytes += bytes;
    if (this->main_memory) {
       ++this->reads;
+      if (dram)
+         dram->access(addr, bytes, false, dram_arrival());
+      if (memory_analysis)
+         memory_analysis->read(addr, bytes);
       return;
    }
 
+   unsigned long end = addr + bytes;
+   for (unsigned long start = addr; start < end; start = ((start >> block_length) + 1) << block_length)
+      read_block(start, std::min(end, ((start >> block_length) + 1) << block_length) - start);
+}
+
+/**
+ * READS: Page-table entry read issued by the TLB's page walker to the L1. The entry is read through this level like any
+ * other request, so page-table entries compete with data for capacity and their misses reach the levels below, but it
+ * is not a CPU access: the CPU read counters of this level are left unchanged, and the misses are returned for the TLB
+ * to report instead.
+ *
+ * @param addr the physical address of the page-table entry.
+ * @param bytes the size of the entry, in bytes.
+ * @return the number of read misses (block or sector) the entry caused at this level.
+ */
+uint_fast64_t Cache::page_walk_read(const unsigned long &addr, uint_fast32_t bytes) {
+   const uint_fast64_t cpu_reads = reads, cpu_read_hits = read_hits, cpu_read_misses = read_misses,
+           cpu_sector_misses = sector_misses, cpu_vc_swaps = vc_swaps, cpu_vc_swap_requests = vc_swap_requests,
+           cpu_read_requests = read_requests, cpu_read_bytes = read_bytes;
+   read(addr, bytes);
+   const uint_fast64_t misses = read_misses - cpu_read_misses;
+
+   reads = cpu_reads, read_hits = cpu_read_hits, read_misses = cpu_read_misses, sector_misses = cpu_sector_misses;
+   vc_swaps = cpu_vc_swaps, vc_swap_requests = cpu_vc_swap_requests;
+   read_requests = cpu_read_requests, read_bytes = cpu_read_bytes;
+   return misses;
+}
+
+/**
+ * WRITES: Main IO interface for CPU writes to this level of the memory hierarchy. A CPU access touches a single sector
+ * of a single block. With a TLB, the address is virtual and is translated first (page walks read through this level).
+ * Repeat hits on the most-recently-used block are retired by the MRU filter without a set search.
+ *
+ * @param addr the address in memory requested by the CPU.
+ */
+void Cache::write(const unsigned long &addr) {
+   const unsigned long physical_addr = tlb ? tlb->translate(addr) : addr;
+
+   // Repeat hit on the most-recently-used block: only the counters and dirty bits change
+   Block *block = mru_filter_lookup(physical_addr);
+   if (block) {
+      ++writes;
+      ++write_hits;
+      ++write_requests;
+      ++write_bytes;
+      block->dirty = true;
+      block->dirty_sectors |= sector_mask(physical_addr, 1);
+      return;
+   }
+   write(physical_addr, 1);
+}
+
+/**
+ * WRITES: Inter-level interface for a write (writeback) request of a given length, split across every block of this
+ * level that it overlaps.
+ *
+ * @param addr the first address of the transfer requested by the caller (CPU or higher-level of hierarchy).
+ * @param bytes the length of the transfer, in bytes.
+ */
+void Cache::write(const unsigned long &addr, uint_fast32_t bytes) {
+   ++write_requests;
+   write_bytes += bytes;
+   // If (this) is a main memory, it always HITS. Increment counter (and queue the write at the DRAM, if modeled).
+   if (this->main_memory) {
+      ++this->writes;
+      if (dram)
+         dram->access(addr, bytes, true, dram_arrival());
+      if (memory_analysis)
+         memory_analysis->write(addr, bytes);
+      return;
+   }
+
+   unsigned long end = addr + bytes;
+   for (unsigned long start = addr; start < end; start = ((start >> block_length) + 1) << block_length)
+      write_block(start, std::min(end, ((start >> block_length) + 1) << block_length) - start);
+}
+
+/**
+ * Read the sectors of one block of this level. Recursively reads/writes back on cache misses and local evictions to
+ * the next level down the hierarchy. If a victim cache exists at this level, utilizes the victim cache in the case of a
+ * miss. A tag hit whose requested sectors are not all valid is a (sector) miss that fetches only the missing sectors.
+ *
+ * @param addr the first address read, which lies within a single block of this level.
+ * @param bytes the number of bytes read from addr, not crossing the end of the block.
+ */
+void Cache::read_block(const unsigned long &addr, uint_fast32_t bytes) {
    // Separate tag, index, block offset
    uint_fast32_t tag,index;
    extract_tag_index(&tag, &index, &addr);
+   uint32_t wanted = sector_mask(addr, bytes);
+   unsigned long base_addr = (addr >> block_length) << block_length;
 
    // Search the set at the calculated index for the requested block
-   auto block = std::find_if(sets[index].blocks.begin(), sets[index].blocks.end(), [&](Block b) {
-      return b.valid && b.tag == tag;
-   });
+   Block *block = sets[index].find(tag);
 
-   if (block == sets[index].blocks.end()) {
+   if (block == nullptr) {
       // Block was not found, cache MISS, increment counter and select a victim block to evict (LRU)
       ++read_misses;
-      auto oldest_block = std::find_if(sets[index].blocks.begin(), sets[index].blocks.end(), [&](Block b) {
-         return b.recency == local_assoc - 1;
-      });
+      if (profiler)
+         profiler->record_miss(addr);
+      Block *oldest_block = &sets[index].lru();
 
       // Always check if the requested block is in the victim cache. Evals to false and continues if no VC exists.
-      if(attempt_vc_swap(addr, index, &*oldest_block)) {
+      if(attempt_vc_swap(addr, index, oldest_block)) {
          ++reads;
-         update_set_recency(sets[index], *oldest_block);
+         fetch_sectors(oldest_block, base_addr, wanted);
+         make_mru(index, *oldest_block, addr);
          return;
       }
 
       // VC Does not exist or swap failed; if victim block is dirty, writeback to next level
       if (oldest_block->dirty) {
          ++write_backs;
-         next_level->write(((oldest_block->tag << index_length) + index) << block_length);
+         write_back_sectors(oldest_block, ((oldest_block->tag << index_length) + index) << block_length);
       }
 
-      // Retrieve requested block from next level
-      next_level->read(addr);
-
-      // Emplace retrieved block into set and update set recency counters
+      // Emplace the requested block into set, retrieving its requested sectors from the next level
       oldest_block->valid = true;
       oldest_block->tag = tag;
       oldest_block->dirty = false;
-      update_set_recency(sets[index], *oldest_block);
+      oldest_block->valid_sectors = 0;
+      oldest_block->dirty_sectors = 0;
+      fetch_sectors(oldest_block, base_addr, wanted);
+      make_mru(index, *oldest_block, addr);
+   } else if ((block->valid_sectors & wanted) != wanted) {
+      // Tag HIT but requested sectors are absent: sector MISS. Fetch the missing sectors only.
+      ++read_misses;
+      ++sector_misses;
+      if (profiler)
+         profiler->record_miss(addr);
+      fetch_sectors(block, base_addr, wanted);
+      make_mru(index, *block, addr);
    } else {
       // Cache read HIT. Update counter and recencies.
       ++read_hits;
-      update_set_recency(sets[index], *block);
+      make_mru(index, *block, addr);
    }
    ++reads;
 }
 
 /**
- * WRITES: Main IO interface for writes to this level of the memory hierarchy. Recursively writes/read-allocates and
- * writes back on cache misses and local evictions to the next level down the hierarchy. If a victim cache exists at
- * this level, utilizes the victim cache in the case of a miss.
+ * Write the sectors of one block of this level. Recursively writes/read-allocates and writes back on cache misses and
+ * local evictions to the next level down the hierarchy. If a victim cache exists at this level, utilizes the victim
+ * cache in the case of a miss. Missing sectors are allocated from the next level before being written.
  *
- * @param addr the address in memory requested by the caller (CPU or higher-level of hierarchy).
+ * @param addr the first address written, which lies within a single block of this level.
+ * @param bytes the number of bytes written from addr, not crossing the end of the block.
  */
-void Cache::write(const unsigned long &addr) {
-   // If (this) is a main memory, it always HITS. Increment counter and return.
-   if (this->main_memory) {
-      ++this->writes;
-      return;
-   }
-
+void Cache::write_block(const unsigned long &addr, uint_fast32_t bytes) {
    // Separate tag, index, block offset
    uint_fast32_t tag,index;
    extract_tag_index(&tag, &index, &addr);
+   uint32_t wanted = sector_mask(addr, bytes);
+   unsigned long base_addr = (addr >> block_length) << block_length;
 
    // Search the set at the calculated index for the requested block
-   auto block = std::find_if(sets[index].blocks.begin(), sets[index].blocks.end(), [&](Block b) {
-      return b.valid && b.tag == tag;
-   });
+   Block *block = sets[index].find(tag);
 
-   if (block == sets[index].blocks.end()) {
+   if (block == nullptr) {
       // Block was not found, cache MISS.
       ++write_misses;
+      if (profiler)
+         profiler->record_miss(addr);
       // Find Oldest block
-      auto oldest_block = std::find_if(sets[index].blocks.begin(), sets[index].blocks.end(), [&](Block b) {
-         return b.recency == local_assoc - 1;
-      });
+      Block *oldest_block = &sets[index].lru();
 
       // Check if block is available in the victim cache, if so, swap. Evals false and continues if VC does not exist.
-      if(attempt_vc_swap(addr, index, &*oldest_block)) {
-         update_set_recency(sets[index], *oldest_block);
+      if(attempt_vc_swap(addr, index, oldest_block)) {
+         fetch_sectors(oldest_block, base_addr, wanted);
+         make_mru(index, *oldest_block, addr);
          oldest_block->dirty = true;
+         oldest_block->dirty_sectors |= wanted;
          ++writes;
          return;
       }
@@ -226,32 +425,139 @@ void Cache::write(const unsigned long &addr) {
       // If victim block is dirty, writeback to next level
       if (oldest_block->dirty) {
          ++write_backs;
-         next_level->write(((oldest_block->tag << index_length) + index) << block_length);
+         write_back_sectors(oldest_block, ((oldest_block->tag << index_length) + index) << block_length);
       }
 
-      // Allocate this block from next level in preparation to write.
-      next_level->read(addr);
-
-      // Emplace allocated block into set
+      // Emplace this block into set, allocating its written sectors from next level in preparation to write.
       oldest_block->valid = true;
       oldest_block->tag = tag;
+      oldest_block->valid_sectors = 0;
+      oldest_block->dirty_sectors = 0;
+      fetch_sectors(oldest_block, base_addr, wanted);
 
       // WRITE TO this block, and set dirty bit.
       oldest_block->dirty = true;
+      oldest_block->dirty_sectors = wanted;
 
       // Traverse and update recency
-      update_set_recency(sets[index], *oldest_block);
+      make_mru(index, *oldest_block, addr);
    } else {
-      //Block was found in this set, cache HIT. Write to block.
+      if ((block->valid_sectors & wanted) != wanted) {
+         // Tag HIT but written sectors are absent: sector MISS. Allocate the missing sectors before writing.
+         ++write_misses;
+         ++sector_misses;
+         if (profiler)
+            profiler->record_miss(addr);
+         fetch_sectors(block, base_addr, wanted);
+      } else {
+         ++write_hits;
+      }
+      //Block was found in this set. Write to block.
       block->dirty = true;
-      ++write_hits;
+      block->dirty_sectors |= wanted;
 
       //If the recency hierarchy has changed, traverse the set and update recencies
-      update_set_recency(sets[index], *block);
+      make_mru(index, *block, addr);
    }
    ++writes;
 }
 
+/**
+ * MRU filter: determine whether a CPU access is a hit on a block that is already most-recently-used in its set, so that
+ * it can be retired without a set search or recency walk. The last accessed block is checked first; in per-set mode the
+ * MRU way of the addressed set is checked next. Both are exact, as MRU blocks only change through accesses to this
+ * level, which record the new MRU block.
+ *
+ * @param addr the address requested by the CPU
+ * @return the MRU block holding the requested sector, or nullptr if the access must take the full path
+ */
+inline Block *Cache::mru_filter_lookup(const unsigned long &addr) {
+   if (this->level != L1 || params.mru_filter == MRU_FILTER_OFF)
+      return nullptr;
+
+   uint32_t wanted = sector_mask(addr, 1);
+   if (mru_block && (addr >> block_length) == mru_block_number) {
+      if ((mru_block->valid_sectors & wanted) != wanted)
+         return nullptr;
+      ++mru_filter_hits;
+      return mru_block;
+   }
+
+   if (params.mru_filter == MRU_FILTER_SET) {
+      uint_fast32_t tag, index;
+      extract_tag_index(&tag, &index, &addr);
+      Block &block = sets[index].blocks[sets[index].mru_way];
+      if (block.valid && block.tag == tag && (block.valid_sectors & wanted) == wanted) {
+         ++mru_filter_hits;
+         mru_block = &block;
+         mru_block_number = addr >> block_length;
+         return mru_block;
+      }
+   }
+   return nullptr;
+}
+
+/**
+ * Make a block the most-recently-used of its set after an access, and record it for the MRU filter.
+ *
+ * @param index the index of the set holding the block
+ * @param block the accessed block
+ * @param addr an address within the accessed block
+ */
+inline void Cache::make_mru(uint_fast32_t index, Block &block, const unsigned long &addr) {
+   sets[index].make_mru(block);
+   mru_block = &block;
+   mru_block_number = addr >> block_length;
+}
+
+/**
+ * Retrieve the wanted sectors of a block that are not yet valid from the next level. Each contiguous run of missing
+ * sectors is merged into a single read request.
+ *
+ * @param block the block receiving the sectors; its valid sector mask is updated.
+ * @param base_addr the full-length address of the first byte of the block
+ * @param wanted mask of the sectors that must be valid on return
+ */
+void Cache::fetch_sectors(Block *block, const unsigned long &base_addr, uint32_t wanted) {
+   uint32_t missing = wanted & ~block->valid_sectors;
+   for (uint_fast32_t s = 0; missing != 0; ) {
+      if (!(missing & (1u << s))) {
+         ++s;
+         continue;
+      }
+      uint_fast32_t run = s;
+      while (run < sectors_per_block && (missing & (1u << run)))
+         missing &= ~(1u << run++);
+      next_level->read(base_addr + (s << sector_length), (run - s) << sector_length);
+      s = run;
+   }
+   block->valid_sectors |= wanted;
+}
+
+/**
+ * Write the dirty sectors of an evicted block back to the next level. Each contiguous run of dirty sectors is merged
+ * into a single write request. The block is left clean.
+ *
+ * @param block the block being written back
+ * @param base_addr the full-length address of the first byte of the block
+ */
+void Cache::write_back_sectors(Block *block, const unsigned long &base_addr) {
+   uint32_t dirty = block->dirty_sectors;
+   for (uint_fast32_t s = 0; dirty != 0; ) {
+      if (!(dirty & (1u << s))) {
+         ++s;
+         continue;
+      }
+      uint_fast32_t run = s;
+      while (run < sectors_per_block && (dirty & (1u << run)))
+         dirty &= ~(1u << run++);
+      next_level->write(base_addr + (s << sector_length), (run - s) << sector_length);
+      s = run;
+   }
+   block->dirty = false;
+   block->dirty_sectors = 0;
+}
+
 /*********************************************** VICTIM CACHE METHODS ************************************************/
 
 /**
@@ -264,13 +570,7 @@ inline bool Cache::vc_has_block(const uint_fast32_t &addr) {
    uint_fast32_t tag = addr >> (block_length);
    uint_fast32_t index = 0;
 
-   auto block = std::find_if(sets[index].blocks.begin(), sets[index].blocks.end(), [&](Block b) {
-      return b.valid && b.tag == tag;
-   });
-
-   if (block == sets[index].blocks.end())
-      return false;
-   return true;
+   return sets[index].find(tag) != nullptr;
 }
 
 /**
@@ -294,18 +594,23 @@ bool Cache::attempt_vc_swap(const unsigned long &addr, uint_fast32_t index, Bloc
       incoming_block->tag = incoming_block->tag >> index_length;
       ++vc_swap_requests;
       ++vc_swaps;
-      update_set_recency(sets[index], *incoming_block);
+      sets[index].make_mru(*incoming_block);
 
       // Swap was a success, return true.
       return true;
-   } else if (victim_cache && !victim_cache->vc_has_block(addr) && incoming_block->valid) {
+   }
+
+   // The victim cache (if any) missed
+   if (victim_cache && victim_cache->profiler)
+      victim_cache->profiler->record_miss(addr);
+
+   if (victim_cache && !victim_cache->vc_has_block(addr) && incoming_block->valid) {
       //Victim cache exists and doesn't have requested block. Push selected victim block into VC
       victim_cache->vc_insert_block(&*incoming_block, ((incoming_block->tag << index_length) + index) << block_length);
 
       // If swapped block from VC to be evicted is dirty, writeback to next level
       if(incoming_block->dirty && incoming_block->valid) {
-         next_level->write(incoming_block->tag  << block_length);
-         incoming_block->dirty = false;
+         write_back_sectors(incoming_block, incoming_block->tag << block_length);
          ++write_backs;
       }
       // Remove index bits from tag to match this cache's set-associativity.
@@ -332,14 +637,12 @@ inline void Cache::vc_execute_swap(Block *incoming_block, const unsigned long &w
    uint_fast32_t wanted_tag=wanted_addr>>block_length, wanted_index=0;
    uint_fast32_t sent_tag = sent_addr>>block_length;
 
-   Block *outgoing_block = &*std::find_if(sets[wanted_index].blocks.begin(), sets[wanted_index].blocks.end(), [&](Block b) {
-      return b.valid && b.tag == wanted_tag;
-   });
+   Block *outgoing_block = sets[wanted_index].find(wanted_tag);
 
-   // swap the dirty bits
-   bool temp_dirty = outgoing_block->dirty;
-   outgoing_block->dirty = incoming_block->dirty;
-   incoming_block->dirty = temp_dirty;
+   // swap the dirty bits and the per-sector valid/dirty masks
+   std::swap(outgoing_block->dirty, incoming_block->dirty);
+   std::swap(outgoing_block->valid_sectors, incoming_block->valid_sectors);
+   std::swap(outgoing_block->dirty_sectors, incoming_block->dirty_sectors);
 
    // Swap the tags/data. NOTE: In the caller, we must right shift the wanted_index out of the returned block.
    incoming_block->tag = outgoing_block->tag;
@@ -348,7 +651,7 @@ inline void Cache::vc_execute_swap(Block *incoming_block, const unsigned long &w
    outgoing_block->valid = true;
 
    //If the recency hierarchy has changed, traverse the set and update recencies
-   update_set_recency(sets[wanted_index], *outgoing_block);
+   sets[wanted_index].make_mru(*outgoing_block);
 }
 
 /**
@@ -364,14 +667,12 @@ inline void Cache::vc_insert_block(Block *incoming_block, const unsigned long &s
    uint_fast32_t sent_tag = sent_addr>>block_length, sent_index=0;
 
    // Find Oldest block
-   auto oldest_block = std::find_if(sets[sent_index].blocks.begin(), sets[sent_index].blocks.end(), [&](Block b) {
-      return b.recency == local_assoc - 1;
-   });
+   Block *oldest_block = &sets[sent_index].lru();
 
-   // swap the dirty bits
-   bool temp_dirty = oldest_block->dirty;
-   oldest_block->dirty = incoming_block->dirty;
-   incoming_block->dirty = temp_dirty;
+   // swap the dirty bits and the per-sector valid/dirty masks
+   std::swap(oldest_block->dirty, incoming_block->dirty);
+   std::swap(oldest_block->valid_sectors, incoming_block->valid_sectors);
+   std::swap(oldest_block->dirty_sectors, incoming_block->dirty_sectors);
 
    // Swap the tags. In the caller, we must right shift the sent_index out to match caller set associativity.
    incoming_block->tag = oldest_block->tag;
@@ -380,7 +681,7 @@ inline void Cache::vc_insert_block(Block *incoming_block, const unsigned long &s
    oldest_block->valid = true;
 
    //If the recency hierarchy has changed, traverse the set and update recencies
-   update_set_recency(sets[sent_index], *oldest_block);
+   sets[sent_index].make_mru(*oldest_block);
 }
 
 /********************************************* UTILITY METHODS *******************************************************/
@@ -400,20 +701,49 @@ inline void Cache::extract_tag_index(uint_fast32_t *tag, uint_fast32_t *index, c
 }
 
 /**
- * Traverse a given set, and update the recency of the blocks within that set based on an access to the passed-in block.
- * The passed-in block becomes most recent (recency=0), the recency of older blocks than the passed-in block stays the
- * same, and the recency of newer blocks is incremented by 1.
+ * Calculate the mask of sectors, within the block containing addr, that are touched by an access of the given length.
  *
- * @param set reference to the full set of blocks needing recency updated
- * @param block the block to be updated as most-recently-accessed
+ * @param addr the first address accessed
+ * @param bytes the length of the access, in bytes, not crossing the end of the block
+ * @return bitmask with one bit set per touched sector (bit 0 for the first sector of the block)
  */
-inline void Cache::update_set_recency(Set &set, Block &block) {
-   if (block.recency != 0) {
-      for (Block &traversal_block: set.blocks)
-         if (traversal_block < block)
-            ++traversal_block.recency;
-      block.recency = 0;
-   }
+inline uint32_t Cache::sector_mask(const unsigned long &addr, uint_fast32_t bytes) const {
+   uint_fast32_t first = (addr & (block_size - 1)) >> sector_length;
+   uint_fast32_t last = ((addr + bytes - 1) & (block_size - 1)) >> sector_length;
+   return (uint32_t) ((((uint64_t) 2 << last) - 1) & ~(((uint64_t) 1 << first) - 1));
+}
+
+/**
+ * The DRAM cycle at which a request reaching main memory arrives: the CPU accesses made so far, scaled by the DRAM
+ * cycles per access.
+ *
+ * @return the arrival time, in DRAM cycles
+ */
+inline uint_fast64_t Cache::dram_arrival() const {
+   return (uint_fast64_t) ((double) (cpu_level->reads + cpu_level->writes) * dram->configuration().cycles_per_access);
+}
+
+/**
+ * Whether this hierarchy uses a single, unsectored block size throughout (the original report format applies).
+ *
+ * @return true if every level shares block_size and no level is sectored.
+ */
+bool Cache::uniform_geometry() const {
+   return params.l2_block_size == params.block_size && params.l1_sectors == 1 && params.l2_sectors == 1;
+}
+
+// Names of the MRU filter modes, indexed by mru_filters
+static const char *mru_filter_names[] = {"off", "last", "set"};
+
+/**
+ * Calculate a ratio rounded to four decimal places, as in the text report, treating an empty denominator as zero.
+ *
+ * @param numerator the event count
+ * @param denominator the access count
+ * @return the rounded ratio
+ */
+static double rounded_rate(double numerator, double denominator) {
+   return denominator == 0 ? 0.0 : std::round(10000 * numerator / denominator) / 10000;
 }
 
 /******************************************** STATISTICS and REPORTING ***********************************************/
@@ -425,73 +755,80 @@ inline void Cache::update_set_recency(Set &set, Block &block) {
  * Recursively call for subsequent victim caches and levels until the entire hierarchy has been reported on.
  */
 void Cache::contents_report() {
+   OutputWriter out(stdout);
+   contents_report(out);
+}
+
+/**
+ * Write the contents report for this level, its victim cache and every level below it through a shared writer.
+ *
+ * @param out the buffered writer receiving the report
+ */
+void Cache::contents_report(OutputWriter &out) {
    if (this->main_memory) {
       return;
    }
 
    else if(this->level==VC) { // Print victim cache header, contents, and return if this is a VC.
-      std::cout << "===== VC contents =====\n";
-      cache_line_report(0);
-      std::cout << std::endl;
+      out.put("===== VC contents =====\n");
+      cache_line_report(out, 0);
+      out.put('\n');
       return;
    }
    else { // Print cache level header and continue
-      std::cout << "===== L" << std::to_string(this->level) << " contents =====\n";
+      out.put("===== L").put_uint(this->level).put(" contents =====\n");
    }
    // Print the contents of each set to console
    for (size_t i = 0; i < sets.size(); ++i)
-      cache_line_report(i);
-   std::cout << "\n";
+      cache_line_report(out, i);
+   out.put('\n');
 
    //If this cache level has a victim cache attached, recursively run report on the VC
    if(victim_cache)
-      victim_cache->contents_report();
+      victim_cache->contents_report(out);
 
    // Recursively run report on the next level of the memory hierarchy
-   this->next_level->contents_report();
+   this->next_level->contents_report(out);
 }
 
 /**
- * For a given set, traverse set and print entire contents as well as dirty status.
+ * For a given set, traverse set in recency order (most recent first) and print entire contents as well as dirty
+ * status. The recencies within a set are always a permutation of 0..assoc-1, so the blocks are ordered by indexing
+ * rather than by copying and sorting the set.
  *
- * @param set_num
+ * @param out the buffered writer receiving the report
+ * @param set_num index of the set to report
  */
-void Cache::cache_line_report(uint8_t set_num) {
-   std::string output = "  set  ";
+void Cache::cache_line_report(OutputWriter &out, size_t set_num) {
+   out.put("  set  ");
    if (set_num <= 9 )
-      output += " ";
-   output += std::to_string(set_num);
-   output += ": ";
+      out.put(' ');
+   out.put_uint(set_num).put(": ");
 
-   // Copy the set and sort it
-   std::vector<Block> temp_set = sets[set_num].blocks;
-   std::sort(temp_set.begin(), temp_set.end());
+   order_by_recency(sets[set_num]);
 
-   // Traverse the set and Convert the contents to a string
-   for (Block &b : temp_set) {
+   // Traverse the set and write out the contents
+   for (const Block *b : recency_order) {
       // Handle the fact that the example code uses an extra space for victim caches here.
-      this->level == VC ? output += " " : output += "  ";
-
-      if(b.valid) { // If this block is valid, concatenate contents
-         // convert unsigned 32 long to hex string
-         std::stringstream ss;
-         ss << std::hex << b.tag;
-         output += ss.str();
-         output += " ";
-         if (b.dirty)
-            output += "D";
-         else
-            output += " ";
-      }
-      else
-      { // If block is invalid/empty, simply concatenate a whitespace-padded dash
-         output += "   -     ";
-      }
+      this->level == VC ? out.put(' ') : out.put("  ");
+
+      if(b->valid) // If this block is valid, write tag and dirty status
+         out.put_hex(b->tag).put(' ').put(b->dirty ? 'D' : ' ');
+      else // If block is invalid/empty, simply write a whitespace-padded dash
+         out.put("   -     ");
    }
-   output += "\n";
+   out.put('\n');
+}
 
-   // Print contents to console
-   std::cout << output;
+/**
+ * Fill recency_order with the blocks of a set, most recently used first.
+ *
+ * @param set the set to order
+ */
+void Cache::order_by_recency(const Set &set) {
+   recency_order.resize(set.blocks.size());
+   for (const Block &b : set.blocks)
+      recency_order[b.recency] = &b;
 }
 
 /**
@@ -502,6 +839,16 @@ void Cache::statistics_report() {
    if (this->level == L1) {
       L1_stats_report();
       next_level->statistics_report();
+      if (!uniform_geometry())
+         traffic_report();
+      if (tlb)
+         tlb_report();
+      if ((next_level->level == L2 ? next_level->next_level : next_level)->dram)
+         dram_report();
+      if (profiler) {
+         OutputWriter out(stdout);
+         profile_report(out);
+      }
       return;
    }
    L2_stats_report();
@@ -557,23 +904,546 @@ void Cache::L2_stats_report() {
       cat_padded(&output, (this->next_level->reads + this->next_level->writes));
    } else { // This hierarchy DOES NOT HAVE a level-2 cache, and this method is being called on the main memory.
       output += "  j. number of L2 reads:                ";
-      cat_padded(&output, (uint_fast32_t) 0);
+      cat_padded(&output, (uint_fast64_t) 0);
       output += "  k. number of L2 read misses:          ";
-      cat_padded(&output, (uint_fast32_t) 0);
+      cat_padded(&output, (uint_fast64_t) 0);
       output += "  l. number of L2 writes:               ";
-      cat_padded(&output, (uint_fast32_t) 0);
+      cat_padded(&output, (uint_fast64_t) 0);
       output += "  m. number of L2 write misses:         ";
-      cat_padded(&output, (uint_fast32_t) 0);
+      cat_padded(&output, (uint_fast64_t) 0);
       output += "  n. L2 miss rate:                      ";
       cat_padded(&output, 0.0); //Todo miss rate
       output += "  o. number of writebacks from L2:      ";
-      cat_padded(&output, (uint_fast32_t) 0);
+      cat_padded(&output, (uint_fast64_t) 0);
       output += "  p. total memory traffic:              ";
       cat_padded(&output, (this->reads + this->writes));
    }
    std::cout << output;
 }
 
+/**
+ * Report sector misses and the traffic between levels, in requests and in bytes, to the console. Only called on the L1,
+ * and only for hierarchies with per-level block sizes or sectoring.
+ */
+void Cache::traffic_report() {
+   std::string output = "===== Traffic =====\n";
+   output += "  number of L1 sector misses:           ";
+   cat_padded(&output, (uint_fast64_t) this->sector_misses);
+
+   Cache *memory = this->next_level;
+   if (next_level->level == L2) {
+      output += "  number of L2 sector misses:           ";
+      cat_padded(&output, (uint_fast64_t) next_level->sector_misses);
+      output += "  L1 to L2 traffic (requests):          ";
+      cat_padded(&output, (uint_fast64_t) (next_level->read_requests + next_level->write_requests));
+      output += "  L1 to L2 traffic (bytes):             ";
+      cat_padded(&output, (uint_fast64_t) (next_level->read_bytes + next_level->write_bytes));
+      memory = next_level->next_level;
+   }
+   output += "  total memory traffic (requests):      ";
+   cat_padded(&output, (uint_fast64_t) (memory->read_requests + memory->write_requests));
+   output += "  total memory traffic (bytes):         ";
+   cat_padded(&output, (uint_fast64_t) (memory->read_bytes + memory->write_bytes));
+
+   std::cout << output;
+}
+
+/**
+ * Report address translation: TLB misses at each level, page walks and the page-table reads they issued to the L1 (and
+ * how many of those missed there), and the pages mapped. Only called on an L1 with a TLB.
+ */
+void Cache::tlb_report() {
+   const tlb_params &config = tlb->configuration();
+   const tlb_statistics &stats = tlb->statistics();
+   std::string output = "===== TLB =====\n";
+   output += "  page size:                            ";
+   cat_padded(&output, (uint_fast64_t) config.page_size);
+   output += "  number of translations:               ";
+   cat_padded(&output, (uint_fast64_t) stats.translations);
+   output += "  number of L1 TLB misses:              ";
+   cat_padded(&output, (uint_fast64_t) stats.l1_misses);
+   output += "  L1 TLB miss rate:                     ";
+   cat_padded(&output, rounded_rate((double) stats.l1_misses, (double) stats.translations));
+   if (config.l2_entries > 0) {
+      output += "  number of L2 TLB misses:              ";
+      cat_padded(&output, (uint_fast64_t) stats.l2_misses);
+      output += "  L2 TLB miss rate:                     ";
+      cat_padded(&output, rounded_rate((double) stats.l2_misses, (double) stats.l1_misses));
+   }
+   output += "  number of page walks:                 ";
+   cat_padded(&output, (uint_fast64_t) stats.walks);
+   output += "  number of page walk reads:            ";
+   cat_padded(&output, (uint_fast64_t) stats.walk_reads);
+   output += "  number of page walk L1 read misses:   ";
+   cat_padded(&output, (uint_fast64_t) stats.walk_read_misses);
+   output += "  number of pages mapped:               ";
+   cat_padded(&output, (uint_fast64_t) stats.pages_mapped);
+   output += "  number of page tables:                ";
+   cat_padded(&output, (uint_fast64_t) stats.page_tables);
+
+   std::cout << output;
+}
+
+/**
+ * Report the DRAM model: its organization, address mapping and request rate, the bursts it served, how they met the row
+ * buffers, read latency, and the bandwidth used over the run, noting when the open-loop request rate saturated it. Only
+ * called on an L1 whose main memory has a DRAM model.
+ */
+void Cache::dram_report() {
+   Dram *memory = (next_level->level == L2 ? next_level->next_level : next_level)->dram;
+   memory->drain();
+   const dram_params &config = memory->configuration();
+   const dram_statistics &stats = memory->statistics();
+   uint_fast64_t bursts = stats.reads + stats.writes;
+   double seconds = (double) stats.elapsed / (config.clock_mhz * 1e6);
+   char mapping[11];
+   Dram::format_mapping(config.mapping, mapping);
+   std::string mapping_string = mapping;
+
+   std::string output = "===== DRAM =====\n";
+   output += "  channels:                             ";
+   cat_padded(&output, (uint_fast64_t) config.channels);
+   output += "  ranks per channel:                    ";
+   cat_padded(&output, (uint_fast64_t) config.ranks);
+   output += "  banks per rank:                       ";
+   cat_padded(&output, (uint_fast64_t) config.banks);
+   output += "  address mapping:                  ";
+   cat_padded(&output, &mapping_string);
+   output += "  DRAM cycles per CPU access:           ";
+   cat_padded(&output, config.cycles_per_access);
+   output += "  number of read bursts:                ";
+   cat_padded(&output, (uint_fast64_t) stats.reads);
+   output += "  number of write bursts:               ";
+   cat_padded(&output, (uint_fast64_t) stats.writes);
+   output += "  number of row buffer hits:            ";
+   cat_padded(&output, (uint_fast64_t) stats.row_hits);
+   output += "  number of row buffer misses:          ";
+   cat_padded(&output, (uint_fast64_t) stats.row_misses);
+   output += "  number of bank conflicts:             ";
+   cat_padded(&output, (uint_fast64_t) stats.row_conflicts);
+   output += "  row buffer hit rate:                  ";
+   cat_padded(&output, rounded_rate((double) stats.row_hits, (double) bursts));
+   output += "  average read latency (cycles):        ";
+   // Rounded to whole cycles: queueing behind a saturated channel can take the average past six digits
+   double latency = stats.reads ? (double) stats.read_latency / (double) stats.reads : 0.0;
+   cat_padded(&output, (uint_fast64_t) std::llround(latency));
+   output += "  elapsed DRAM cycles:                  ";
+   cat_padded(&output, (uint_fast64_t) stats.elapsed);
+   output += "  bandwidth used (GB/s):                ";
+   cat_padded(&output, seconds > 0 ? (double) (bursts * config.burst_size) / seconds / 1e9 : 0.0);
+   output += "  data bus utilization:                 ";
+   cat_padded(&output, rounded_rate((double) stats.bus_busy, (double) stats.elapsed * (double) config.channels));
+   output += "  number of queue-full stalls:          ";
+   cat_padded(&output, (uint_fast64_t) stats.queue_full_stalls);
+   output += "  number of write drains:               ";
+   cat_padded(&output, (uint_fast64_t) stats.write_drains);
+   if (stats.queue_full_stalls > 0) {
+      output += "  requests arrive open loop (the CPU never stalls on a miss), so the queues saturated and the read\n";
+      output += "  latency above is mostly queueing; raise --dram-cycles-per-access to model a slower request rate\n";
+   }
+
+   std::cout << output;
+}
+
+/**
+ * Report the miss profile of every profiled level: the misses recorded, the estimated distinct blocks that missed (the
+ * unique-block footprint, at the L1), and the top pages and blocks by estimated misses with their share of the level's
+ * misses. Only called on the L1.
+ *
+ * @param out where to write the report
+ */
+void Cache::profile_report(OutputWriter &out) {
+   Cache *hierarchy[4];
+   size_t levels_count = hierarchy_levels(hierarchy);
+   for (size_t l = 0; l < levels_count; ++l) {
+      const MissProfiler *p = hierarchy[l]->profiler;
+      if (!p)
+         continue;
+      double unique_blocks = std::round(p->unique_blocks());
+      out.put("===== Miss profile: ").put(hierarchy[l]->level_name()).put(" =====\n");
+      out.put("  number of misses profiled:            ").put_uint(p->profiled_misses(), 12).put('\n');
+      out.put("  unique blocks missed (estimate):      ").put_uint((uint_fast64_t) unique_blocks, 12).put('\n');
+      out.put("  unique-block footprint (estimate, KB):")
+         .put_uint((uint_fast64_t) (unique_blocks * (double) p->block_bytes() / 1024), 12).put('\n');
+
+      const struct { const char *title; std::vector<hot_region> regions; } tables[] = {
+              {"  top missing pages:\n", p->top_pages()}, {"  top missing blocks:\n", p->top_blocks()}};
+      for (const auto &table : tables) {
+         out.put(table.title).put("      rank          address      misses     share\n");
+         for (size_t rank = 0; rank < table.regions.size(); ++rank) {
+            const hot_region &r = table.regions[rank];
+            out.put_uint(rank + 1, 10).put_hex(r.address, 17).put_uint(r.misses, 12).put("    ")
+               .put_fixed(rounded_rate((double) r.misses, (double) p->profiled_misses()), 4).put('\n');
+         }
+      }
+   }
+}
+
+/**
+ * Collect the headline results of the run across the hierarchy. Only called on the L1.
+ *
+ * @return the summary counters
+ */
+hierarchy_summary Cache::summarize() const {
+   hierarchy_summary summary = {};
+   summary.accesses = reads + writes;
+   summary.l1_misses = read_misses + write_misses;
+   summary.vc_swaps = vc_swaps;
+   summary.l1_write_backs = write_backs;
+
+   const Cache *memory = next_level;
+   if (next_level->level == L2) {
+      summary.l2_reads = next_level->reads;
+      summary.l2_read_misses = next_level->read_misses;
+      summary.l2_misses = next_level->read_misses + next_level->write_misses;
+      memory = next_level->next_level;
+   }
+   summary.memory_requests = memory->reads + memory->writes;
+   summary.memory_bytes = memory->read_bytes + memory->write_bytes;
+   return summary;
+}
+
+/**
+ * Pass every read and write request that reaches main memory to a stack-distance analysis, which then measures an LRU
+ * level placed between this hierarchy and memory at every associativity in one run. The analysis is not owned, and must
+ * outlive the hierarchy's accesses.
+ *
+ * @param analysis the analysis receiving the requests
+ */
+void Cache::analyze_memory_requests(StackDistance *analysis) {
+   Cache *memory = this;
+   while (!memory->main_memory)
+      memory = memory->next_level;
+   memory->memory_analysis = analysis;
+}
+
+/************************************** STRUCTURED (JSON/CSV) REPORTING **********************************************/
+
+/**
+ * Collect the levels of the hierarchy below and including this one, in report order: this level, its victim cache, then
+ * each next level down to (and including) main memory.
+ *
+ * @param hierarchy array of at least four entries receiving the levels
+ * @return the number of levels written
+ */
+size_t Cache::hierarchy_levels(Cache **hierarchy) {
+   size_t count = 0;
+   for (Cache *c = this; c; c = c->main_memory ? nullptr : c->next_level) {
+      hierarchy[count++] = c;
+      if (c->victim_cache)
+         hierarchy[count++] = c->victim_cache;
+   }
+   return count;
+}
+
+/**
+ * Human-readable name for this level in structured reports.
+ *
+ * @return "L1", "L2", "VC" or "MEM"
+ */
+const char *Cache::level_name() const {
+   switch (level) {
+      case L1: return "L1";
+      case L2: return "L2";
+      case VC: return "VC";
+      default: return "MEM";
+   }
+}
+
+/**
+ * Gather the counters reported for this level. Main memory reports only its request and byte counts.
+ *
+ * @param counters array of at least 16 entries receiving name/value pairs
+ * @return the number of counters written
+ */
+size_t Cache::report_counters(report_counter *counters) const {
+   size_t count = 0;
+   counters[count++] = {"reads", reads};
+   counters[count++] = {"writes", writes};
+   if (!main_memory) {
+      counters[count++] = {"read_hits", read_hits};
+      counters[count++] = {"read_misses", read_misses};
+      counters[count++] = {"write_hits", write_hits};
+      counters[count++] = {"write_misses", write_misses};
+      counters[count++] = {"sector_misses", sector_misses};
+      counters[count++] = {"write_backs", write_backs};
+      counters[count++] = {"swap_requests", vc_swap_requests};
+      counters[count++] = {"swaps", vc_swaps};
+      counters[count++] = {"read_requests", read_requests};
+      counters[count++] = {"write_requests", write_requests};
+   }
+   counters[count++] = {"read_bytes", read_bytes};
+   counters[count++] = {"write_bytes", write_bytes};
+   return count;
+}
+
+/**
+ * Gather the hierarchy settings recorded in the configuration of structured reports: the geometry of every level, with
+ * defaulted per-level geometry resolved, the MRU filter mode, and the TLB, miss profiler and DRAM configurations when
+ * they are enabled. Only called on the L1.
+ *
+ * @param settings receives the settings, in report order
+ */
+void Cache::configuration_settings(std::vector<report_setting> *settings) const {
+   const report_counter geometry[] = {
+           {"block_size", params.block_size}, {"l1_size", params.l1_size}, {"l1_assoc", params.l1_assoc},
+           {"vc_num_blocks", params.vc_num_blocks}, {"l2_size", params.l2_size}, {"l2_assoc", params.l2_assoc},
+           {"l2_block_size", params.l2_block_size}, {"l1_sectors", params.l1_sectors},
+           {"l2_sectors", params.l2_sectors}};
+   for (const report_counter &c : geometry)
+      settings->push_back({c.name, std::to_string(c.value), true});
+
+   settings->push_back({"mru_filter", mru_filter_names[params.mru_filter], false});
+
+   // Address translation, with defaults applied
+   if (tlb) {
+      const tlb_params &t = tlb->configuration();
+      const report_counter translation[] = {
+              {"tlb_entries", t.l1_entries}, {"tlb_assoc", t.l1_assoc}, {"l2_tlb_entries", t.l2_entries},
+              {"l2_tlb_assoc", t.l2_assoc}, {"page_size", t.page_size}, {"physical_memory", t.physical_memory},
+              {"mapping_seed", t.mapping_seed}};
+      for (const report_counter &c : translation)
+         settings->push_back({c.name, std::to_string(c.value), true});
+   }
+
+   if (profiler)
+      settings->push_back({"profile_top_k", std::to_string(params.profile_top_k), true});
+
+   // DRAM timing model behind main memory, with defaults applied
+   const Cache *memory = next_level;
+   while (!memory->main_memory)
+      memory = memory->next_level;
+   if (memory->dram) {
+      const dram_params &d = memory->dram->configuration();
+      const report_counter organization[] = {
+              {"dram_channels", d.channels}, {"dram_ranks", d.ranks}, {"dram_banks", d.banks}, {"dram_rows", d.rows},
+              {"dram_row_size", d.row_size}, {"dram_queue_depth", d.queue_depth}};
+      for (const report_counter &c : organization)
+         settings->push_back({c.name, std::to_string(c.value), true});
+      char mapping[11], number[32];
+      Dram::format_mapping(d.mapping, mapping);
+      settings->push_back({"dram_mapping", mapping, false});
+      snprintf(number, sizeof(number), "%g", d.clock_mhz);
+      settings->push_back({"dram_clock", number, true});
+      snprintf(number, sizeof(number), "%g", d.cycles_per_access);
+      settings->push_back({"dram_cycles_per_access", number, true});
+      settings->push_back({"dram_timings", std::to_string(d.t_cl) + "," + std::to_string(d.t_rcd) + "," +
+                                           std::to_string(d.t_rp) + "," + std::to_string(d.t_ras), false});
+   }
+}
+
+/**
+ * Report how many L1 accesses the MRU filter retired without a set search. Only called on the L1.
+ *
+ * @param stream where to write the report
+ */
+void Cache::filter_report(FILE *stream) const {
+   fprintf(stream, "===== MRU filter =====\n");
+   fprintf(stream, "  filter mode:                          %12s\n", mru_filter_names[params.mru_filter]);
+   fprintf(stream, "  number of filter hits:                %12lu\n", (unsigned long) mru_filter_hits);
+   fprintf(stream, "  filter hit ratio:                     %12.4f\n",
+           rounded_rate((double) mru_filter_hits, (double) (reads + writes)));
+}
+
+/**
+ * Report the hierarchy configuration, the counters of every level (and of the TLB and DRAM, if any), the summary rates
+ * of the text report, the miss profile of every profiled level, and (optionally) the contents of every cache to stdout
+ * in JSON or CSV form. Called on the L1.
+ *
+ * @param format FORMAT_JSON or FORMAT_CSV
+ * @param run_settings settings of the run outside the hierarchy (such as the trace), recorded after the hierarchy's own
+ * @param include_contents whether to emit the per-block contents of every cache
+ */
+void Cache::structured_report(report_formats format, const std::vector<report_setting> &run_settings,
+                              bool include_contents) {
+   OutputWriter out(stdout);
+   Cache *hierarchy[4];
+   size_t levels_count = hierarchy_levels(hierarchy);
+   Cache *memory = hierarchy[levels_count - 1];
+   Cache *l2 = next_level->level == L2 ? next_level : nullptr;
+
+   std::vector<report_setting> config;
+   configuration_settings(&config);
+   config.insert(config.end(), run_settings.begin(), run_settings.end());
+   const struct { const char *name; double value; } rates[] = {
+           {"swap_request_rate", rounded_rate(vc_swap_requests, reads + writes)},
+           {"l1_vc_miss_rate", rounded_rate(read_misses + write_misses - vc_swaps, reads + writes)},
+           {"l2_miss_rate", l2 ? rounded_rate(l2->read_misses, l2->reads) : 0.0}};
+   const report_counter totals[] = {
+           {"memory_traffic_requests", memory->reads + memory->writes},
+           {"memory_traffic_bytes", memory->read_bytes + memory->write_bytes}};
+   report_counter counters[16];
+
+   // DRAM timing, reported only when main memory has a DRAM model
+   report_counter dram_counters[13];
+   size_t dram_count = 0;
+   if (memory->dram) {
+      memory->dram->drain();
+      const dram_params &d = memory->dram->configuration();
+      const dram_statistics &ds = memory->dram->statistics();
+      const report_counter timing[] = {
+              {"channels", d.channels}, {"ranks", d.ranks}, {"banks", d.banks}, {"read_bursts", ds.reads},
+              {"write_bursts", ds.writes}, {"row_hits", ds.row_hits}, {"row_misses", ds.row_misses},
+              {"bank_conflicts", ds.row_conflicts}, {"read_latency_cycles", ds.read_latency},
+              {"bus_busy_cycles", ds.bus_busy}, {"elapsed_cycles", ds.elapsed},
+              {"queue_full_stalls", ds.queue_full_stalls}, {"write_drains", ds.write_drains}};
+      for (const report_counter &c : timing)
+         dram_counters[dram_count++] = c;
+   }
+
+   // Address translation, reported only when a TLB is configured
+   report_counter tlb_counters[13];
+   size_t tlb_count = 0;
+   if (tlb) {
+      const tlb_params &t = tlb->configuration();
+      const tlb_statistics &ts = tlb->statistics();
+      const report_counter translation[] = {
+              {"l1_entries", t.l1_entries}, {"l1_assoc", t.l1_assoc}, {"l2_entries", t.l2_entries},
+              {"l2_assoc", t.l2_assoc}, {"page_size", t.page_size}, {"translations", ts.translations},
+              {"l1_misses", ts.l1_misses}, {"l2_misses", ts.l2_misses}, {"walks", ts.walks},
+              {"walk_reads", ts.walk_reads}, {"walk_read_misses", ts.walk_read_misses},
+              {"pages_mapped", ts.pages_mapped}, {"page_tables", ts.page_tables}};
+      for (const report_counter &c : translation)
+         tlb_counters[tlb_count++] = c;
+   }
+
+   if (format == FORMAT_CSV) {
+      out.put("record,level,name,set,way,value\n");
+      for (const report_setting &c : config)
+         out.put("config,,").put(c.name).put(",,,").put_csv_field(c.value.c_str()).put('\n');
+      for (size_t l = 0; l < levels_count; ++l) {
+         size_t count = hierarchy[l]->report_counters(counters);
+         for (size_t i = 0; i < count; ++i)
+            out.put("counter,").put(hierarchy[l]->level_name()).put(',').put(counters[i].name).put(",,,")
+               .put_uint(counters[i].value).put('\n');
+      }
+      for (const auto &r : rates)
+         out.put("summary,,").put(r.name).put(",,,").put_fixed(r.value, 4).put('\n');
+      for (const report_counter &t : totals)
+         out.put("summary,,").put(t.name).put(",,,").put_uint(t.value).put('\n');
+      for (size_t i = 0; i < tlb_count; ++i)
+         out.put("counter,TLB,").put(tlb_counters[i].name).put(",,,").put_uint(tlb_counters[i].value).put('\n');
+      for (size_t i = 0; i < dram_count; ++i)
+         out.put("counter,DRAM,").put(dram_counters[i].name).put(",,,").put_uint(dram_counters[i].value).put('\n');
+      for (size_t l = 0; l < levels_count; ++l) {
+         const MissProfiler *p = hierarchy[l]->profiler;
+         if (!p)
+            continue;
+         const char *name = hierarchy[l]->level_name();
+         out.put("profile,").put(name).put(",misses,,,").put_uint(p->profiled_misses()).put('\n');
+         out.put("profile,").put(name).put(",unique_blocks,,,").put_uint((uint_fast64_t) std::round(p->unique_blocks()))
+            .put('\n');
+         for (const hot_region &r : p->top_pages())
+            out.put("top_page,").put(name).put(',').put_hex(r.address).put(",,,").put_uint(r.misses).put('\n');
+         for (const hot_region &r : p->top_blocks())
+            out.put("top_block,").put(name).put(',').put_hex(r.address).put(",,,").put_uint(r.misses).put('\n');
+      }
+      if (include_contents) {
+         for (size_t l = 0; l < levels_count; ++l) {
+            Cache *c = hierarchy[l];
+            if (c->main_memory)
+               continue;
+            for (size_t set_num = 0; set_num < c->sets.size(); ++set_num) {
+               c->order_by_recency(c->sets[set_num]);
+               for (size_t way = 0; way < c->recency_order.size(); ++way) {
+                  const Block *b = c->recency_order[way];
+                  if (!b->valid)
+                     continue;
+                  out.put("block,").put(c->level_name()).put(b->dirty ? ",dirty," : ",clean,").put_uint(set_num)
+                     .put(',').put_uint(way).put(',').put_hex(b->tag).put('\n');
+               }
+            }
+         }
+      }
+      return;
+   }
+
+   // JSON
+   out.put("{\n  \"config\": {");
+   for (size_t i = 0; i < config.size(); ++i) {
+      out.put(i ? ", \"" : "\"").put(config[i].name).put("\": ");
+      if (config[i].numeric)
+         out.put(config[i].value);
+      else
+         out.put_json_string(config[i].value.c_str());
+   }
+   out.put("},\n  \"levels\": [");
+   for (size_t l = 0; l < levels_count; ++l) {
+      out.put(l ? ",\n    {" : "\n    {").put("\"level\": \"").put(hierarchy[l]->level_name()).put('"');
+      size_t count = hierarchy[l]->report_counters(counters);
+      for (size_t i = 0; i < count; ++i)
+         out.put(", \"").put(counters[i].name).put("\": ").put_uint(counters[i].value);
+      out.put('}');
+   }
+   out.put("\n  ],\n  \"summary\": {");
+   for (const auto &r : rates)
+      out.put('"').put(r.name).put("\": ").put_fixed(r.value, 4).put(", ");
+   out.put('"').put(totals[0].name).put("\": ").put_uint(totals[0].value).put(", \"").put(totals[1].name).put("\": ")
+      .put_uint(totals[1].value).put('}');
+   if (tlb_count) {
+      out.put(",\n  \"tlb\": {");
+      for (size_t i = 0; i < tlb_count; ++i)
+         out.put(i ? ", \"" : "\"").put(tlb_counters[i].name).put("\": ").put_uint(tlb_counters[i].value);
+      out.put('}');
+   }
+   if (dram_count) {
+      out.put(",\n  \"dram\": {");
+      for (size_t i = 0; i < dram_count; ++i)
+         out.put(i ? ", \"" : "\"").put(dram_counters[i].name).put("\": ").put_uint(dram_counters[i].value);
+      out.put('}');
+   }
+   bool first_profile = true;
+   for (size_t l = 0; l < levels_count; ++l) {
+      const MissProfiler *p = hierarchy[l]->profiler;
+      if (!p)
+         continue;
+      out.put(first_profile ? ",\n  \"profile\": [\n    {" : ",\n    {");
+      first_profile = false;
+      out.put("\"level\": \"").put(hierarchy[l]->level_name()).put("\", \"misses\": ").put_uint(p->profiled_misses())
+         .put(", \"unique_blocks\": ").put_uint((uint_fast64_t) std::round(p->unique_blocks()));
+      const struct { const char *name; std::vector<hot_region> regions; } tables[] = {
+              {"top_pages", p->top_pages()}, {"top_blocks", p->top_blocks()}};
+      for (const auto &table : tables) {
+         out.put(", \"").put(table.name).put("\": [");
+         for (size_t i = 0; i < table.regions.size(); ++i)
+            out.put(i ? ", {\"address\": \"" : "{\"address\": \"").put_hex(table.regions[i].address)
+               .put("\", \"misses\": ").put_uint(table.regions[i].misses).put('}');
+         out.put(']');
+      }
+      out.put('}');
+   }
+   if (!first_profile)
+      out.put("\n  ]");
+   if (include_contents) {
+      out.put(",\n  \"contents\": [");
+      bool first_level = true;
+      for (size_t l = 0; l < levels_count; ++l) {
+         Cache *c = hierarchy[l];
+         if (c->main_memory)
+            continue;
+         out.put(first_level ? "\n    {" : ",\n    {").put("\"level\": \"").put(c->level_name()).put("\", \"sets\": [");
+         first_level = false;
+         for (size_t set_num = 0; set_num < c->sets.size(); ++set_num) {
+            out.put(set_num ? ",\n      [" : "\n      [");
+            c->order_by_recency(c->sets[set_num]);
+            for (size_t way = 0; way < c->recency_order.size(); ++way) {
+               const Block *b = c->recency_order[way];
+               if (way)
+                  out.put(", ");
+               if (b->valid)
+                  out.put("{\"tag\": \"").put_hex(b->tag).put(b->dirty ? "\", \"dirty\": true}" : "\", \"dirty\": false}");
+               else
+                  out.put("null");
+            }
+            out.put(']');
+         }
+         out.put("\n    ]}");
+      }
+      out.put("\n  ]");
+   }
+   out.put("\n}\n");
+}
+
 /************************************** STRING MANIPULATION METHODS **************************************************/
 
 /**
@@ -583,10 +1453,10 @@ void Cache::L2_stats_report() {
  * @param str the string to be concatenated to
  * @param n the integer to emplace at the end of the string.
  */
-void Cache::cat_padded(std::string *str, uint_fast32_t n) {
+void Cache::cat_padded(std::string *str, uint_fast64_t n) {
    std::string value = std::to_string(n);
-   while (value.length() < 12)
-      value = " " + value;
+   if (value.length() < 12)
+      value.insert(0, 12 - value.length(), ' ');
    value += "\n";
    *str += value;
 }
@@ -600,8 +1470,8 @@ void Cache::cat_padded(std::string *str, uint_fast32_t n) {
  */
 void Cache::cat_padded(std::string *str, double n) {
    std::string value = std::to_string(n).substr(0, 6);
-   while (value.length() < 12)
-      value = " " + value;
+   if (value.length() < 12)
+      value.insert(0, 12 - value.length(), ' ');
    value += "\n";
    *str += value;
 }
@@ -615,8 +1485,8 @@ void Cache::cat_padded(std::string *str, double n) {
  */
 void Cache::cat_padded(std::string *head, std::string *tail) {
    std::string value = *tail;
-   while (value.length() < 16)
-      value = " " + value;
+   if (value.length() < 16)
+      value.insert(0, 16 - value.length(), ' ');
    value += "\n";
    *head += value;
 }
\ No newline at end of file
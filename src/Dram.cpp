@@ -0,0 +1,319 @@
+/**
+ * Dram.cpp Source code for the Dram class, which times main-memory requests through channels, ranks and banks with
+ * open row buffers, scheduling each channel's read and write queues FR-FCFS.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "Dram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Two-letter names of the address fields, indexed by dram_fields
+static const char *field_names[] = {"Ro", "Ra", "Ba", "Ch", "Co"};
+
+/**
+ * Resolve defaulted parameters (see dram_params).
+ *
+ * @param params the parameters to complete in place
+ */
+static void apply_defaults(dram_params *params) {
+   static const uint8_t default_mapping[] = {DRAM_ROW, DRAM_RANK, DRAM_BANK, DRAM_CHANNEL, DRAM_COLUMN};
+   const struct { unsigned long int *field; unsigned long int value; } defaults[] = {
+           {&params->ranks, 1}, {&params->banks, 16}, {&params->rows, 65536}, {&params->row_size, 8192},
+           {&params->burst_size, 64}, {&params->queue_depth, 32}, {&params->t_cl, 17}, {&params->t_rcd, 17},
+           {&params->t_rp, 17}, {&params->t_ras, 39}, {&params->t_cwl, 12}, {&params->t_wr, 18},
+           {&params->t_burst, 4}, {&params->t_turnaround, 2}};
+   if (params->clock_mhz <= 0)
+      params->clock_mhz = 1200;
+   for (const auto &d : defaults)
+      if (*d.field == 0)
+         *d.field = d.value;
+   if (params->mapping[0] == params->mapping[1])
+      memcpy(params->mapping, default_mapping, sizeof(default_mapping));
+   if (params->cycles_per_access <= 0)
+      params->cycles_per_access = 1;
+}
+
+/**
+ * Construct the channels and banks, and derive the position of each address field from the mapping. The burst offset
+ * occupies the lowest bits; fields follow from the least significant end of the mapping.
+ *
+ * @param params the DRAM configuration, which must have passed validate()
+ */
+Dram::Dram(const dram_params &params) {
+   this->params = params;
+   apply_defaults(&this->params);
+
+   field_length[DRAM_ROW] = log2(this->params.rows);
+   field_length[DRAM_RANK] = log2(this->params.ranks);
+   field_length[DRAM_BANK] = log2(this->params.banks);
+   field_length[DRAM_CHANNEL] = log2(this->params.channels);
+   field_length[DRAM_COLUMN] = log2(this->params.row_size / this->params.burst_size);
+   uint_fast32_t shift = log2(this->params.burst_size);
+   for (size_t i = 5; i-- > 0; ) {
+      field_shift[this->params.mapping[i]] = shift;
+      shift += field_length[this->params.mapping[i]];
+   }
+
+   Channel channel = {};
+   channel.banks.assign(this->params.ranks * this->params.banks, Bank{false, 0, 0, 0});
+   channel.reads.reserve(this->params.queue_depth);
+   channel.writes.reserve(this->params.queue_depth);
+   channels.assign(this->params.channels, channel);
+   stats = {};
+
+   // Drain from 3/4 full down to 1/4, keeping at least one write queued to start a drain and one fewer to end it
+   drain_high_watermark = std::max<size_t>(1, this->params.queue_depth * 3 / 4);
+   drain_low_watermark = std::min<size_t>(this->params.queue_depth / 4, drain_high_watermark - 1);
+}
+
+/**
+ * Check a DRAM configuration: every count and size must be a power of two, channels, ranks, banks and queue depth must
+ * not exceed their MAX_DRAM_* bounds, a row must hold at least one burst, and the channel, rank, bank, row and column
+ * fields of an address (with the burst offset) must fit in 64 bits.
+ *
+ * @param params the configuration to check (defaults are applied to a copy)
+ * @param error receives a description of the first problem found
+ * @return true if the configuration is valid
+ */
+bool Dram::validate(const dram_params &params, const char **error) {
+   dram_params p = params;
+   apply_defaults(&p);
+   for (unsigned long int n : {p.channels, p.ranks, p.banks, p.rows, p.row_size, p.burst_size}) {
+      if (n == 0 || (n & (n - 1)) != 0) {
+         *error = "DRAM channels, ranks, banks, rows, row size and burst size must be powers of two";
+         return false;
+      }
+   }
+   if (p.channels > MAX_DRAM_CHANNELS || p.ranks > MAX_DRAM_RANKS || p.banks > MAX_DRAM_BANKS ||
+       p.queue_depth > MAX_DRAM_QUEUE_DEPTH) {
+      *error = "At most 64 DRAM channels, 16 ranks, 256 banks and a 65536-entry queue depth are supported";
+      return false;
+   }
+   if (p.row_size < p.burst_size) {
+      *error = "A DRAM row must hold at least one burst";
+      return false;
+   }
+   if (log2(p.channels) + log2(p.ranks) + log2(p.banks) + log2(p.rows) + log2(p.row_size) > 64) {
+      *error = "DRAM channels, ranks, banks, rows and row size must together fit in 64 address bits";
+      return false;
+   }
+   return true;
+}
+
+/**
+ * Parse an address mapping: the five fields "Ro", "Ra", "Ba", "Ch" and "Co", each exactly once, most significant first.
+ *
+ * @param text the mapping, e.g. "RoRaBaChCo"
+ * @param mapping receives the five dram_fields
+ * @return true if the mapping was well-formed
+ */
+bool Dram::parse_mapping(const char *text, uint8_t *mapping) {
+   if (strlen(text) != 10)
+      return false;
+   bool seen[5] = {};
+   for (size_t i = 0; i < 5; ++i) {
+      size_t f = 0;
+      while (f < 5 && strncmp(text + 2 * i, field_names[f], 2) != 0)
+         ++f;
+      if (f == 5 || seen[f])
+         return false;
+      seen[f] = true;
+      mapping[i] = (uint8_t) f;
+   }
+   return true;
+}
+
+/**
+ * Format an address mapping as its field names, most significant first.
+ *
+ * @param mapping the five dram_fields
+ * @param text receives the null-terminated mapping (11 characters)
+ */
+void Dram::format_mapping(const uint8_t *mapping, char *text) {
+   for (size_t i = 0; i < 5; ++i)
+      memcpy(text + 2 * i, field_names[mapping[i]], 2);
+   text[10] = '\0';
+}
+
+/*********************************************** REQUEST HANDLING ****************************************************/
+
+/**
+ * Queue a transfer, split into bursts, at the channels its bursts map to. Each channel first schedules everything it
+ * could have issued before the transfer arrived.
+ *
+ * @param addr the first physical address of the transfer
+ * @param bytes the length of the transfer
+ * @param write whether the transfer is a write (write-back) rather than a read (fill)
+ * @param arrival the DRAM cycle at which the transfer arrives
+ */
+void Dram::access(unsigned long addr, uint_fast32_t bytes, bool write, uint_fast64_t arrival) {
+   unsigned long end = addr + bytes;
+   for (unsigned long burst = addr & ~(params.burst_size - 1); burst < end; burst += params.burst_size) {
+      uint_fast32_t channel_index;
+      Request request;
+      decode(burst, &channel_index, &request);
+      request.arrival = request.ready = arrival;
+      request.write = write;
+      enqueue(channels[channel_index], request);
+   }
+}
+
+/**
+ * Split a physical address into its channel, rank, bank and row. Addresses beyond the capacity wrap around.
+ *
+ * @param addr the physical address
+ * @param channel receives the channel index
+ * @param request receives the rank, bank and row
+ */
+void Dram::decode(unsigned long addr, uint_fast32_t *channel, Request *request) const {
+   auto field = [&](dram_fields f) {
+      return (uint_fast64_t) (addr >> field_shift[f]) & (((uint_fast64_t) 1 << field_length[f]) - 1);
+   };
+   *channel = field(DRAM_CHANNEL);
+   request->rank = field(DRAM_RANK);
+   request->bank = field(DRAM_BANK);
+   request->row = field(DRAM_ROW);
+}
+
+/**
+ * The cycle at which a channel makes its next scheduling decision: once its scheduler is free and its oldest queued
+ * request is ready.
+ *
+ * @param channel a channel with at least one queued request
+ * @return the decision time
+ */
+uint_fast64_t Dram::next_issue_time(const Channel &channel) const {
+   uint_fast64_t oldest = UINT64_MAX;
+   if (!channel.reads.empty())
+      oldest = channel.reads.front().ready;
+   if (!channel.writes.empty())
+      oldest = std::min(oldest, channel.writes.front().ready);
+   return std::max(channel.next_decision, oldest);
+}
+
+/**
+ * Add a request to its channel's queue. Requests the channel could have issued before this arrival are issued first;
+ * if the queue is still full, the channel issues until a slot frees, and the request becomes ready at that time. Its
+ * arrival is kept, so the stall counts towards its latency.
+ *
+ * @param channel the channel the request maps to
+ * @param request the decoded request
+ */
+void Dram::enqueue(Channel &channel, const Request &request) {
+   while ((!channel.reads.empty() || !channel.writes.empty()) && next_issue_time(channel) <= request.arrival)
+      issue(channel);
+
+   std::vector<Request> &queue = request.write ? channel.writes : channel.reads;
+   Request queued = request;
+   if (queue.size() >= params.queue_depth) {
+      ++stats.queue_full_stalls;
+      while (queue.size() >= params.queue_depth)
+         issue(channel);
+      queued.ready = std::max(queued.ready, channel.next_decision);
+   }
+   queue.push_back(queued);
+}
+
+/**
+ * Make one scheduling decision on a channel and issue the chosen request. Reads are served unless the read queue is
+ * empty or the write queue is being drained (from the high watermark of 3/4 full down to the low watermark of 1/4, see
+ * the constructor). In the chosen queue, the oldest ready request to an open row goes first (FR-FCFS); otherwise the
+ * oldest request.
+ *
+ * @param channel a channel with at least one queued request
+ */
+void Dram::issue(Channel &channel) {
+   uint_fast64_t now = next_issue_time(channel);
+
+   // Choose the queue
+   if (!channel.draining_writes && channel.writes.size() >= drain_high_watermark) {
+      channel.draining_writes = true;
+      ++stats.write_drains;
+   } else if (channel.draining_writes && channel.writes.size() <= drain_low_watermark) {
+      channel.draining_writes = false;
+   }
+   bool serve_writes = channel.reads.empty() || (channel.draining_writes && !channel.writes.empty()) ||
+                       (!channel.writes.empty() && channel.reads.front().ready > now);
+   std::vector<Request> &queue = serve_writes ? channel.writes : channel.reads;
+
+   // First ready: the oldest ready request whose row is open; otherwise first come, first served
+   size_t chosen = 0;
+   for (size_t i = 0; i < queue.size(); ++i) {
+      const Bank &bank = channel.banks[queue[i].rank * params.banks + queue[i].bank];
+      if (queue[i].ready <= now && bank.open && bank.row == queue[i].row) {
+         chosen = i;
+         break;
+      }
+   }
+   Request request = queue[chosen];
+   queue.erase(queue.begin() + chosen);
+   now = std::max(now, request.ready);
+
+   // Open the row if needed: activate a closed bank, or precharge and activate on a conflict
+   Bank &bank = channel.banks[request.rank * params.banks + request.bank];
+   uint_fast64_t start = std::max(now, bank.ready), column, row_command = 0;
+   bool row_hit = bank.open && bank.row == request.row;
+   if (row_hit) {
+      ++stats.row_hits;
+      column = start;
+   } else {
+      row_command = start;
+      if (bank.open) {
+         ++stats.row_conflicts;
+         row_command = std::max(start, bank.precharge_ready);
+         column = row_command + params.t_rp + params.t_rcd;
+      } else {
+         ++stats.row_misses;
+         column = row_command + params.t_rcd;
+      }
+      bank.open = true;
+      bank.row = request.row;
+      bank.precharge_ready = column - params.t_rcd + params.t_ras;
+   }
+
+   // Issue the column command so that its data follows the previous burst on the bus, with a turnaround bubble when
+   // the bus changes direction or rank
+   uint_fast64_t data_latency = request.write ? params.t_cwl : params.t_cl;
+   uint_fast64_t bus_ready = channel.bus_free;
+   if (channel.bus_used && (channel.last_write != request.write || channel.last_rank != request.rank))
+      bus_ready += params.t_turnaround;
+   if (bus_ready > column + data_latency)
+      column = bus_ready - data_latency;
+   uint_fast64_t done = column + data_latency + params.t_burst;
+
+   channel.bus_free = done;
+   channel.bus_used = true;
+   channel.last_write = request.write;
+   channel.last_rank = request.rank;
+   bank.ready = column + params.t_burst;
+   if (request.write)
+      bank.precharge_ready = std::max(bank.precharge_ready, done + params.t_wr);
+
+   // The scheduler moves on once this request's first command (its precharge or activate, or its column command on a
+   // row hit) has issued, so that other banks open rows while this one waits
+   channel.next_decision = (row_hit ? column : row_command) + 1;
+
+   // Statistics
+   stats.bus_busy += params.t_burst;
+   stats.elapsed = std::max(stats.elapsed, done);
+   if (request.write) {
+      ++stats.writes;
+   } else {
+      ++stats.reads;
+      stats.read_latency += done - request.arrival;
+   }
+}
+
+/**
+ * Issue every queued request on every channel. Safe to call more than once.
+ */
+void Dram::drain() {
+   for (Channel &channel : channels)
+      while (!channel.reads.empty() || !channel.writes.empty())
+         issue(channel);
+}
@@ -0,0 +1,626 @@
+/**
+ * Explorer.cpp Source code for the Explorer class, which enumerates cache hierarchies within an area and latency budget,
+ * evaluates them in parallel (one stack-distance pass per associativity family, skipping those already recorded in a
+ * results file), and reports the Pareto frontier of miss rate and memory traffic (in bytes) against area.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "Explorer.h"
+#include "StackDistance.h"
+#include "TraceReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+
+/**
+ * TraceCounter is a trace sink that only counts accesses, used to validate the trace before the search.
+ */
+struct TraceCounter {
+   uint_fast64_t accesses = 0;
+   void read(const unsigned long &) { ++accesses; }
+   void write(const unsigned long &) { ++accesses; }
+};
+
+/*************************************** CONSTRUCTION and SPECIFICATION **********************************************/
+
+/**
+ * Construct an explorer with empty ranges, a zero cost table and unlimited budgets.
+ */
+Explorer::Explorer() {
+   l1_cost = vc_cost = l2_cost = memory_cost = structure_cost();
+   area_budget = 0;
+   latency_budget = 0;
+   threads = std::max(1u, std::thread::hardware_concurrency());
+   invalid_points = over_budget_points = cached_points = stack_points = stack_passes = simulated_points = 0;
+}
+
+/**
+ * Read a spec file. Each non-blank line (after stripping '#' comments) is either a parameter range, a budget, or a row
+ * of the cost table:
+ *    block_size = 16, 32          l1_size = 1024..32768          (a..b lists the powers of two from a to b)
+ *    area_budget = 4.0            latency_budget = 3.5           threads = 8
+ *    cost l1 <area_per_kb> <area_per_block> <latency> <latency_per_size_doubling> <latency_per_assoc_doubling>
+ * Cost rows exist for l1, vc, l2 and memory (the memory row's latency is its access time). vc_num_blocks, l2_size and
+ * l2_assoc default to 0 (no victim cache, no L2).
+ *
+ * @param path the spec file
+ * @param error receives a description of the first problem found
+ * @return true if the spec was read successfully
+ */
+bool Explorer::load_spec(const char *path, std::string *error) {
+   std::ifstream spec(path);
+   if (!spec) {
+      *error = "Unable to open file " + std::string(path);
+      return false;
+   }
+   vc_num_blocks = {0};
+   l2_sizes = {0};
+   l2_assocs = {0};
+
+   std::string line;
+   for (size_t line_number = 1; std::getline(spec, line); ++line_number) {
+      line = line.substr(0, line.find('#'));
+      size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos)
+         continue;
+      line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+      std::string where = std::string(path) + " line " + std::to_string(line_number);
+
+      if (line.compare(0, 5, "cost ") == 0) {
+         std::istringstream row(line.substr(5));
+         std::string structure, values;
+         row >> structure;
+         std::getline(row, values);
+         structure_cost *cost = structure == "l1" ? &l1_cost : structure == "vc" ? &vc_cost :
+                                structure == "l2" ? &l2_cost : structure == "memory" ? &memory_cost : nullptr;
+         if (!cost || !parse_cost(values, cost)) {
+            *error = "Invalid cost row in " + where;
+            return false;
+         }
+         continue;
+      }
+
+      size_t equals = line.find('=');
+      if (equals == std::string::npos) {
+         *error = "Expected name = value in " + where;
+         return false;
+      }
+      std::string name = line.substr(0, line.find_last_not_of(" \t", equals - 1) + 1);
+      std::string value = line.substr(equals + 1);
+
+      bool ok = true;
+      if (name == "block_size")
+         ok = parse_range(value, &block_sizes);
+      else if (name == "l1_size")
+         ok = parse_range(value, &l1_sizes);
+      else if (name == "l1_assoc")
+         ok = parse_range(value, &l1_assocs);
+      else if (name == "vc_num_blocks")
+         ok = parse_range(value, &vc_num_blocks);
+      else if (name == "l2_size")
+         ok = parse_range(value, &l2_sizes);
+      else if (name == "l2_assoc")
+         ok = parse_range(value, &l2_assocs);
+      else if (name == "area_budget" || name == "latency_budget" || name == "threads") {
+         char *end;
+         double n = strtod(value.c_str(), &end);
+         ok = end != value.c_str() && *end == '\0' && n >= 0;
+         if (name == "area_budget")
+            area_budget = n;
+         else if (name == "latency_budget")
+            latency_budget = n;
+         else
+            threads = n >= 1 ? (unsigned int) n : threads;
+      } else {
+         *error = "Unknown setting " + name + " in " + where;
+         return false;
+      }
+      if (!ok) {
+         *error = "Invalid value for " + name + " in " + where;
+         return false;
+      }
+   }
+
+   if (block_sizes.empty() || l1_sizes.empty() || l1_assocs.empty()) {
+      *error = "Spec must give block_size, l1_size and l1_assoc";
+      return false;
+   }
+   return true;
+}
+
+/**
+ * Parse a comma-separated list of values, where each item is a number or a range a..b of the powers of two between a
+ * and b.
+ *
+ * @param text the list
+ * @param values receives the values, sorted and de-duplicated
+ * @return true if the list was well-formed
+ */
+bool Explorer::parse_range(const std::string &text, std::vector<unsigned long int> *values) {
+   values->clear();
+   std::istringstream items(text);
+   std::string item;
+   while (std::getline(items, item, ',')) {
+      const char *p = item.c_str();
+      char *end;
+      unsigned long int low = strtoul(p, &end, 10);
+      if (end == p)
+         return false;
+      unsigned long int high = low;
+      while (*end == ' ' || *end == '\t')
+         ++end;
+      if (end[0] == '.' && end[1] == '.') {
+         p = end + 2;
+         high = strtoul(p, &end, 10);
+         if (end == p || low == 0 || high < low)
+            return false;
+      }
+      while (*end == ' ' || *end == '\t')
+         ++end;
+      if (*end != '\0')
+         return false;
+      for (unsigned long int v = low; v <= high; v = v ? v * 2 : 1) {
+         values->push_back(v);
+         if (v == high)
+            break;
+      }
+   }
+   std::sort(values->begin(), values->end());
+   values->erase(std::unique(values->begin(), values->end()), values->end());
+   return !values->empty();
+}
+
+/**
+ * Parse the five numbers of a cost row.
+ *
+ * @param text the numbers, whitespace separated
+ * @param cost receives the parsed row
+ * @return true if exactly five non-negative numbers were given
+ */
+bool Explorer::parse_cost(const std::string &text, structure_cost *cost) {
+   std::istringstream row(text);
+   std::string extra;
+   if (!(row >> cost->area_per_kb >> cost->area_per_block >> cost->latency >> cost->latency_per_size_doubling
+             >> cost->latency_per_assoc_doubling) || (row >> extra))
+      return false;
+   return cost->area_per_kb >= 0 && cost->area_per_block >= 0 && cost->latency >= 0;
+}
+
+/**
+ * Select the trace to evaluate, checking that it parses, and the results file used to skip known configurations. The
+ * trace is identified in the results file by its path, size and modification time.
+ *
+ * @param trace the trace file
+ * @param results the results file (created if absent)
+ * @param error receives a description of the problem if the trace cannot be used
+ * @return true if the trace is usable
+ */
+bool Explorer::set_trace(const char *trace, const char *results, std::string *error) {
+   TraceReader reader(trace);
+   if (!reader.is_open()) {
+      *error = "Unable to open file " + std::string(trace);
+      return false;
+   }
+   TraceCounter counter;
+   if (!reader.parse(counter)) {
+      if (reader.read_error())
+         *error = "Unable to read " + std::string(trace) + ": " + strerror(reader.read_error());
+      else
+         *error = "Malformed trace line " + std::to_string(reader.malformed_line()) + " in " + trace;
+      return false;
+   }
+   struct stat info;
+   if (stat(trace, &info) != 0) {
+      *error = "Unable to stat file " + std::string(trace);
+      return false;
+   }
+   trace_file = trace;
+   trace_id = trace_file + ":" + std::to_string(reader.size()) + ":" + std::to_string((long long) info.st_mtim.tv_sec) +
+              "." + std::to_string((long) info.st_mtim.tv_nsec);
+   results_file = results;
+   return true;
+}
+
+/************************************************** COST MODEL *******************************************************/
+
+/**
+ * Area of one structure.
+ *
+ * @param cost the structure's cost row
+ * @param bytes data capacity in bytes
+ * @param blocks number of blocks (tags)
+ */
+double Explorer::structure_area(const structure_cost &cost, double bytes, double blocks) {
+   return bytes / 1024.0 * cost.area_per_kb + blocks * cost.area_per_block;
+}
+
+/**
+ * Access latency of one structure.
+ *
+ * @param cost the structure's cost row
+ * @param bytes data capacity in bytes
+ * @param assoc associativity
+ */
+double Explorer::structure_latency(const structure_cost &cost, double bytes, double assoc) {
+   return cost.latency + std::log2(std::max(bytes / 1024.0, 1.0)) * cost.latency_per_size_doubling +
+          std::log2(std::max(assoc, 1.0)) * cost.latency_per_assoc_doubling;
+}
+
+/**
+ * Combined L1+VC miss rate of an evaluated point (misses served by VC swaps count as hits).
+ */
+double Explorer::miss_rate(const explore_point &point) {
+   const hierarchy_summary &r = point.result;
+   return r.accesses ? (double) (r.l1_misses - r.vc_swaps) / (double) r.accesses : 0.0;
+}
+
+/**
+ * Average memory access time of an evaluated point: L1 latency, plus the VC latency on every L1 miss, plus the L2 (and
+ * memory, on an L2 read miss) latency on every L1+VC miss.
+ */
+double Explorer::amat(const explore_point &point) const {
+   const cache_params &p = point.params;
+   const hierarchy_summary &r = point.result;
+   double l1_miss = r.accesses ? (double) r.l1_misses / (double) r.accesses : 0.0;
+   double time = point.l1_latency;
+   if (p.vc_num_blocks)
+      time += l1_miss * structure_latency(vc_cost, (double) (p.vc_num_blocks * p.block_size), p.vc_num_blocks);
+   double beyond = memory_cost.latency;
+   if (p.l2_size) {
+      double l2_miss = r.l2_reads ? (double) r.l2_read_misses / (double) r.l2_reads : 0.0;
+      beyond = structure_latency(l2_cost, (double) p.l2_size, (double) p.l2_assoc) + l2_miss * memory_cost.latency;
+   }
+   return time + miss_rate(point) * beyond;
+}
+
+/**
+ * Whether an evaluated point meets the latency budget.
+ */
+bool Explorer::within_latency_budget(const explore_point &point) const {
+   return latency_budget == 0 || amat(point) <= latency_budget;
+}
+
+/***************************************************** SEARCH ********************************************************/
+
+/**
+ * Enumerate every valid hierarchy in the parameter ranges, discarding those over the area budget or whose L1 alone
+ * exceeds the latency budget. A valid hierarchy has power-of-two block sizes and set counts; without an L2, the L2
+ * associativity is ignored.
+ */
+void Explorer::enumerate() {
+   points.clear();
+   auto power_of_two = [](unsigned long int n) { return n != 0 && (n & (n - 1)) == 0; };
+
+   for (unsigned long int block : block_sizes)
+   for (unsigned long int l1_size : l1_sizes)
+   for (unsigned long int l1_assoc : l1_assocs)
+   for (unsigned long int vc : vc_num_blocks)
+   for (unsigned long int l2_size : l2_sizes)
+   for (unsigned long int l2_assoc : l2_assocs) {
+      if (l2_size == 0 && l2_assoc != l2_assocs.front())
+         continue; // One hierarchy without an L2, whatever the L2 associativity range
+      bool valid = power_of_two(block) && l1_assoc > 0 && l1_size % (l1_assoc * block) == 0 &&
+                   power_of_two(l1_size / (l1_assoc * block));
+      if (l2_size)
+         valid = valid && l2_assoc > 0 && l2_size % (l2_assoc * block) == 0 &&
+                 power_of_two(l2_size / (l2_assoc * block));
+      if (!valid) {
+         ++invalid_points;
+         continue;
+      }
+
+      explore_point point = {};
+      point.params.block_size = block;
+      point.params.l1_size = l1_size;
+      point.params.l1_assoc = l1_assoc;
+      point.params.vc_num_blocks = vc;
+      point.params.l2_size = l2_size;
+      point.params.l2_assoc = l2_size ? l2_assoc : 0;
+      point.params.mru_filter = MRU_FILTER_SET;
+
+      point.area = structure_area(l1_cost, (double) l1_size, (double) (l1_size / block)) +
+                   structure_area(vc_cost, (double) (vc * block), (double) vc) +
+                   structure_area(l2_cost, (double) l2_size, (double) (l2_size / block));
+      point.l1_latency = structure_latency(l1_cost, (double) l1_size, (double) l1_assoc);
+      if ((area_budget > 0 && point.area > area_budget) || (latency_budget > 0 && point.l1_latency > latency_budget)) {
+         ++over_budget_points;
+         continue;
+      }
+      points.push_back(point);
+   }
+}
+
+/**
+ * Key identifying a hierarchy in the results file.
+ */
+std::string Explorer::point_key(const cache_params &params) {
+   return std::to_string(params.block_size) + "," + std::to_string(params.l1_size) + "," +
+          std::to_string(params.l1_assoc) + "," + std::to_string(params.vc_num_blocks) + "," +
+          std::to_string(params.l2_size) + "," + std::to_string(params.l2_assoc);
+}
+
+/**
+ * Load previously simulated results for this trace from the results file. Rows for other traces, and malformed rows,
+ * are ignored. Each row is the trace id, the six hierarchy parameters, then the nine hierarchy_summary counters.
+ */
+void Explorer::load_results() {
+   std::ifstream results(results_file);
+   std::string line;
+   while (std::getline(results, line)) {
+      // The trace id may itself contain commas: the final 15 fields are numeric
+      size_t split = line.size();
+      for (int fields = 0; fields < 15 && split != std::string::npos; ++fields)
+         split = split ? line.rfind(',', split - 1) : std::string::npos;
+      if (split == std::string::npos || line.compare(0, split, trace_id) != 0 || split != trace_id.size())
+         continue;
+
+      unsigned long long v[15];
+      const char *p = line.c_str() + split + 1;
+      bool ok = true;
+      for (int i = 0; i < 15 && ok; ++i) {
+         char *end;
+         v[i] = strtoull(p, &end, 10);
+         ok = end != p && (*end == ',' || (i == 14 && *end == '\0'));
+         p = end + 1;
+      }
+      if (!ok)
+         continue;
+
+      cache_params params = {};
+      params.block_size = v[0], params.l1_size = v[1], params.l1_assoc = v[2];
+      params.vc_num_blocks = v[3], params.l2_size = v[4], params.l2_assoc = v[5];
+      hierarchy_summary summary = {v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13], v[14]};
+      known_results[point_key(params)] = summary;
+   }
+}
+
+/**
+ * Append one evaluated point to the results file.
+ */
+void Explorer::append_result(FILE *results, const explore_point &point) const {
+   const hierarchy_summary &r = point.result;
+   fprintf(results, "%s,%s,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n", trace_id.c_str(),
+           point_key(point.params).c_str(), (unsigned long long) r.accesses, (unsigned long long) r.l1_misses,
+           (unsigned long long) r.vc_swaps, (unsigned long long) r.l1_write_backs, (unsigned long long) r.l2_reads,
+           (unsigned long long) r.l2_read_misses, (unsigned long long) r.l2_misses,
+           (unsigned long long) r.memory_requests, (unsigned long long) r.memory_bytes);
+   fflush(results);
+}
+
+/**
+ * Simulate the trace through one hierarchy.
+ *
+ * @param point the hierarchy; its result is filled in
+ * @param error receives a description of the problem if the trace fails to parse
+ * @return true on success
+ */
+bool Explorer::simulate(explore_point *point, std::string *error) const {
+   TraceReader reader(trace_file.c_str());
+   Cache hierarchy(point->params, L1);
+   if (!reader.is_open() || !reader.parse(hierarchy)) {
+      *error = "Unable to simulate trace " + trace_file;
+      return false;
+   }
+   point->result = hierarchy.summarize();
+   return true;
+}
+
+/**
+ * Evaluate one family in a single stack-distance pass, filling in the result of each member.
+ *  - L2 family: the shared L1 (and VC) is simulated without an L2, and the L2 is measured at every associativity on the
+ *    requests that reach memory. Memory then receives one block per L2 miss, and one per L2 write back.
+ *  - L1 family (no VC, no L2): the L1 is measured on the trace itself. Memory receives one block per L1 miss, and one
+ *    per L1 write back.
+ *
+ * @param members positions in points of the family members to evaluate (same set count, any associativity)
+ * @param error receives a description of the problem if the trace fails to parse
+ * @return true on success
+ */
+bool Explorer::analyze_family(const std::vector<size_t> &members, std::string *error) {
+   const cache_params &first = points[members.front()].params;
+   bool l2_family = first.l2_size != 0;
+   uint_fast32_t block = first.block_size;
+   uint_fast32_t sets = l2_family ? first.l2_size / (first.l2_assoc * block) : first.l1_size / (first.l1_assoc * block);
+   uint_fast32_t max_assoc = 0;
+   for (size_t m : members)
+      max_assoc = std::max(max_assoc, (uint_fast32_t) (l2_family ? points[m].params.l2_assoc : points[m].params.l1_assoc));
+
+   StackDistance analysis(sets, block, max_assoc);
+   TraceReader reader(trace_file.c_str());
+   hierarchy_summary upper = {};
+   bool ok = reader.is_open();
+   if (ok && l2_family) {
+      cache_params l1_only = first;
+      l1_only.l2_size = l1_only.l2_assoc = 0;
+      Cache hierarchy(l1_only, L1);
+      hierarchy.analyze_memory_requests(&analysis);
+      ok = reader.parse(hierarchy);
+      upper = hierarchy.summarize();
+   } else if (ok) {
+      ok = reader.parse(analysis);
+   }
+   if (!ok) {
+      *error = "Unable to simulate trace " + trace_file;
+      return false;
+   }
+
+   for (size_t m : members) {
+      explore_point &point = points[m];
+      stack_counts counts = analysis.counts(l2_family ? point.params.l2_assoc : point.params.l1_assoc);
+      uint_fast64_t misses = counts.read_misses + counts.write_misses;
+      point.result = upper;
+      if (l2_family) {
+         point.result.l2_reads = counts.reads;
+         point.result.l2_read_misses = counts.read_misses;
+         point.result.l2_misses = misses;
+      } else {
+         point.result.accesses = counts.reads + counts.writes;
+         point.result.l1_misses = misses;
+         point.result.l1_write_backs = counts.write_backs;
+      }
+      point.result.memory_requests = misses + counts.write_backs;
+      point.result.memory_bytes = point.result.memory_requests * block;
+   }
+   return true;
+}
+
+/**
+ * Run the given jobs on a pool of worker threads, each taking the next job as soon as it finishes its last, and append
+ * each result to the results file as soon as it completes.
+ *
+ * @param jobs the stack-distance passes and single simulations to run
+ * @param error receives a description of the first failure, if any
+ */
+void Explorer::evaluate(const std::vector<explore_job> &jobs, std::string *error) {
+   if (jobs.empty())
+      return;
+   FILE *results = fopen(results_file.c_str(), "a");
+   if (results && ftell(results) == 0)
+      fprintf(results, "# trace,block_size,l1_size,l1_assoc,vc_num_blocks,l2_size,l2_assoc,accesses,l1_misses,vc_swaps,"
+                       "l1_write_backs,l2_reads,l2_read_misses,l2_misses,memory_requests,memory_bytes\n");
+   std::atomic<size_t> next(0);
+   std::mutex results_lock;
+
+   auto worker = [&]() {
+      for (size_t i = next++; i < jobs.size(); i = next++) {
+         const explore_job &job = jobs[i];
+         std::string failure;
+         bool ok = job.stack_pass ? analyze_family(job.members, &failure) :
+                   simulate(&points[job.members.front()], &failure);
+         std::lock_guard<std::mutex> guard(results_lock);
+         if (!ok) {
+            if (error->empty())
+               *error = failure;
+            continue;
+         }
+         if (job.stack_pass) {
+            ++stack_passes;
+            stack_points += job.members.size();
+         } else {
+            ++simulated_points;
+         }
+         for (size_t m : job.members) {
+            points[m].evaluated = true;
+            if (results)
+               append_result(results, points[m]);
+         }
+      }
+   };
+
+   std::vector<std::thread> pool;
+   unsigned int workers = (unsigned int) std::min<size_t>(threads, jobs.size());
+   for (unsigned int t = 1; t < workers; ++t)
+      pool.emplace_back(worker);
+   worker();
+   for (std::thread &t : pool)
+      t.join();
+   if (results)
+      fclose(results);
+}
+
+/**
+ * Run the search. Points recorded in the results file are reused. The rest are grouped into families that differ only
+ * in the associativity of one LRU cache with a fixed set count (the L2; or the L1 when there is neither VC nor L2); a
+ * family with several members to evaluate becomes one stack-distance pass, and every other point one simulation. All
+ * jobs go to a single pool, longest first, so no worker waits on another.
+ *
+ * @param error receives a description of the problem if simulation fails
+ * @return true on success
+ */
+bool Explorer::run(std::string *error) {
+   enumerate();
+   load_results();
+
+   // Group the points without a recorded result into families
+   std::map<std::string, std::vector<size_t>> families;
+   for (size_t i = 0; i < points.size(); ++i) {
+      explore_point &point = points[i];
+      const cache_params &p = point.params;
+      auto known = known_results.find(point_key(p));
+      if (known != known_results.end()) {
+         point.result = known->second;
+         point.evaluated = point.from_results_file = true;
+         ++cached_points;
+         continue;
+      }
+
+      std::string family;
+      if (p.l2_size)
+         family = "L2:" + std::to_string(p.block_size) + "," + std::to_string(p.l1_size) + "," +
+                  std::to_string(p.l1_assoc) + "," + std::to_string(p.vc_num_blocks) + "," +
+                  std::to_string(p.l2_size / (p.l2_assoc * p.block_size));
+      else if (p.vc_num_blocks == 0)
+         family = "L1:" + std::to_string(p.block_size) + "," + std::to_string(p.l1_size / (p.l1_assoc * p.block_size));
+      else
+         family = "point:" + point_key(p);
+      families[family].push_back(i);
+   }
+
+   // Stack-distance passes first: an L2 family's pass costs a simulation plus the analysis
+   std::vector<explore_job> jobs;
+   for (auto &f : families)
+      if (f.second.size() > 1)
+         jobs.push_back({f.second, true});
+   for (auto &f : families)
+      if (f.second.size() == 1)
+         jobs.push_back({f.second, false});
+
+   evaluate(jobs, error);
+   return error->empty();
+}
+
+/**
+ * Report search statistics and the Pareto frontier: evaluated points within the latency budget that no other such
+ * point matches or beats on area, miss rate and memory traffic (in bytes) together.
+ */
+void Explorer::report() const {
+   std::vector<const explore_point *> frontier;
+   for (const explore_point &p : points) {
+      if (!p.evaluated || !within_latency_budget(p))
+         continue;
+      bool dominated = false;
+      for (const explore_point &q : points) {
+         if (&q == &p || !q.evaluated || !within_latency_budget(q))
+            continue;
+         double pr = miss_rate(p), qr = miss_rate(q);
+         if (q.area <= p.area && qr <= pr && q.result.memory_bytes <= p.result.memory_bytes &&
+             (q.area < p.area || qr < pr || q.result.memory_bytes < p.result.memory_bytes)) {
+            dominated = true;
+            break;
+         }
+      }
+      if (!dominated)
+         frontier.push_back(&p);
+   }
+   std::sort(frontier.begin(), frontier.end(), [](const explore_point *a, const explore_point *b) {
+      return a->area < b->area || (a->area == b->area && miss_rate(*a) < miss_rate(*b));
+   });
+
+   printf("===== Design space exploration =====\n");
+   printf("  trace_file:                      %16s\n", trace_file.c_str());
+   printf("  invalid configurations:              %12lu\n", (unsigned long) invalid_points);
+   printf("  over area/latency budget:            %12lu\n", (unsigned long) over_budget_points);
+   printf("  candidate configurations:            %12lu\n", (unsigned long) points.size());
+   printf("  reused from results file:            %12lu\n", (unsigned long) cached_points);
+   printf("  evaluated by stack-distance passes:  %12lu\n", (unsigned long) stack_points);
+   printf("  stack-distance passes:               %12lu\n", (unsigned long) stack_passes);
+   printf("  simulated individually:              %12lu\n", (unsigned long) simulated_points);
+   printf("\n===== Pareto frontier (area vs. miss rate and memory traffic) =====\n");
+   printf("  %9s %9s %8s %8s %9s %8s %10s %8s %10s %12s %12s\n", "BLOCKSIZE", "L1_SIZE", "L1_ASSOC", "VC_BLKS",
+          "L2_SIZE", "L2_ASSOC", "AREA", "AMAT", "MISS_RATE", "MEM_REQUESTS", "MEM_BYTES");
+   for (const explore_point *p : frontier)
+      printf("  %9lu %9lu %8lu %8lu %9lu %8lu %10.4f %8.3f %10.4f %12llu %12llu\n", p->params.block_size,
+             p->params.l1_size, p->params.l1_assoc, p->params.vc_num_blocks, p->params.l2_size, p->params.l2_assoc,
+             p->area, amat(*p), miss_rate(*p), (unsigned long long) p->result.memory_requests,
+             (unsigned long long) p->result.memory_bytes);
+}
@@ -0,0 +1,166 @@
+/**
+ * MissProfiler.cpp Source code for the MissProfiler class, which attributes the misses of one cache level to pages and
+ * blocks with count-min sketches and top-K tables, and estimates the distinct missing blocks with a HyperLogLog.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "MissProfiler.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Construct an empty profiler. All memory is allocated here and never grows.
+ *
+ * @param top_k the number of pages and of blocks to rank
+ * @param block_length log2 of the block size at the profiled level
+ * @param page_length log2 of the page size
+ */
+MissProfiler::MissProfiler(size_t top_k, uint_fast32_t block_length, uint_fast32_t page_length) {
+   for (HeavyHitters *tracker : {&pages, &blocks}) {
+      tracker->counters.assign(sketch_depth * sketch_width, 0);
+      tracker->top.reserve(top_k);
+      tracker->positions.reserve(top_k);
+      tracker->top_k = top_k;
+   }
+   registers.assign((size_t) 1 << hll_precision, 0);
+   misses = 0;
+   this->block_length = block_length;
+   this->page_length = page_length;
+}
+
+/**
+ * Mix a key into 64 well-distributed bits (the splitmix64 finalizer).
+ *
+ * @param key the key to hash
+ * @return the hash
+ */
+inline uint_fast64_t MissProfiler::hash(uint_fast64_t key) {
+   key += 0x9e3779b97f4a7c15ULL;
+   key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+   return key ^ (key >> 31);
+}
+
+/**
+ * Record a miss on the given address: count its page and block, and add its block to the distinct-block estimate.
+ *
+ * @param addr the address that missed
+ */
+void MissProfiler::record_miss(const unsigned long &addr) {
+   ++misses;
+   uint_fast64_t block = addr >> block_length;
+   pages.add(addr >> page_length);
+   blocks.add(block);
+
+   // HyperLogLog: the top bits select a register, which keeps the longest run of leading zeros seen in the rest
+   uint_fast64_t h = hash(block);
+   size_t index = h >> (64 - hll_precision);
+   uint8_t rank = __builtin_clzll((h << hll_precision) | ((uint_fast64_t) 1 << (hll_precision - 1))) + 1;
+   if (rank > registers[index])
+      registers[index] = rank;
+}
+
+/**
+ * Count one occurrence of a key. The sketch uses conservative update (only the smallest of the key's counters grow),
+ * which keeps estimates tighter for skewed streams. The key then enters the top table if it is not already there and
+ * its estimate exceeds the smallest count in a full table.
+ *
+ * @param key the page or block number
+ */
+void MissProfiler::HeavyHitters::add(uint_fast64_t key) {
+   // Derive every row's column from one hash (Kirsch-Mitzenmacher double hashing)
+   uint_fast64_t h = hash(key);
+   uint_fast64_t h1 = h & 0xffffffff, h2 = (h >> 32) | 1;
+   size_t columns[sketch_depth];
+   uint_fast64_t estimate = UINT64_MAX;
+   for (size_t row = 0; row < sketch_depth; ++row) {
+      columns[row] = row * sketch_width + (h1 + row * h2) % sketch_width;
+      estimate = std::min(estimate, counters[columns[row]]);
+   }
+   ++estimate;
+   for (size_t row = 0; row < sketch_depth; ++row)
+      counters[columns[row]] = std::max(counters[columns[row]], estimate);
+
+   // Estimates only grow, so a key already in a full table has a new estimate above the root: anything else is not in it
+   if (top_k == 0 || (top.size() == top_k && estimate <= top[0].misses))
+      return;
+
+   auto held = positions.find(key);
+   if (held != positions.end()) {
+      top[held->second].misses = estimate;
+      sift_down(held->second);
+   } else if (top.size() < top_k) {
+      // Sift the new key up from the bottom of the heap
+      size_t i = top.size();
+      top.push_back({key, estimate});
+      for (; i > 0 && top[(i - 1) / 2].misses > estimate; i = (i - 1) / 2) {
+         top[i] = top[(i - 1) / 2];
+         positions[top[i].address] = i;
+      }
+      top[i] = {key, estimate};
+      positions[key] = i;
+   } else {
+      positions.erase(top[0].address);
+      top[0] = {key, estimate};
+      positions[key] = 0;
+      sift_down(0);
+   }
+}
+
+/**
+ * Restore the heap order below position i after the count there grew.
+ *
+ * @param i the position whose count grew
+ */
+void MissProfiler::HeavyHitters::sift_down(size_t i) {
+   hot_region moving = top[i];
+   for (size_t child = 2 * i + 1; child < top.size(); i = child, child = 2 * i + 1) {
+      if (child + 1 < top.size() && top[child + 1].misses < top[child].misses)
+         ++child;
+      if (top[child].misses >= moving.misses)
+         break;
+      top[i] = top[child];
+      positions[top[i].address] = i;
+   }
+   top[i] = moving;
+   positions[moving.address] = i;
+}
+
+/**
+ * Estimate the number of distinct blocks recorded, with linear counting for small cardinalities.
+ *
+ * @return the estimate
+ */
+double MissProfiler::unique_blocks() const {
+   double m = (double) registers.size();
+   double sum = 0;
+   size_t zeros = 0;
+   for (uint8_t r : registers) {
+      sum += std::ldexp(1.0, -r);
+      zeros += r == 0;
+   }
+   double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+   if (estimate <= 2.5 * m && zeros > 0)
+      estimate = m * std::log(m / (double) zeros);
+   return estimate;
+}
+
+/**
+ * Order a top table by estimated misses, most-missed first, converting keys back to addresses.
+ *
+ * @param tracker the tracker to rank
+ * @param length log2 of the region size the tracker's keys count
+ * @return the ranked regions
+ */
+std::vector<hot_region> MissProfiler::ranked(const HeavyHitters &tracker, uint_fast32_t length) {
+   std::vector<hot_region> regions = tracker.top;
+   std::sort(regions.begin(), regions.end(), [](const hot_region &a, const hot_region &b) {
+      return a.misses != b.misses ? a.misses > b.misses : a.address < b.address;
+   });
+   for (hot_region &region : regions)
+      region.address <<= length;
+   return regions;
+}
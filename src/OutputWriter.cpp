@@ -0,0 +1,169 @@
+/**
+ * OutputWriter.cpp Source code for the OutputWriter class, a buffered, allocation-free writer used for contents,
+ * statistics and structured (JSON/CSV) reports.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "OutputWriter.h"
+#include <algorithm>
+
+/**
+ * Construct a writer that buffers output for the given stream.
+ *
+ * @param stream the stdio stream written to on flush
+ */
+OutputWriter::OutputWriter(FILE *stream) {
+   this->stream = stream;
+   used = 0;
+}
+
+/**
+ * Flush any remaining output before the writer falls out of scope.
+ */
+OutputWriter::~OutputWriter() {
+   flush();
+}
+
+/**
+ * Write all buffered output to the stream, and flush the stream so that output from other writers (std::cout, printf)
+ * stays in order.
+ */
+void OutputWriter::flush() {
+   if (used > 0)
+      fwrite(buffer, 1, used, stream);
+   used = 0;
+   fflush(stream);
+}
+
+/**
+ * Append n bytes of text. Text longer than the buffer is written straight through.
+ *
+ * @param str the text
+ * @param n its length in bytes
+ */
+OutputWriter &OutputWriter::put(const char *str, size_t n) {
+   if (n > buffer_size) {
+      flush();
+      fwrite(str, 1, n, stream);
+      return *this;
+   }
+   reserve(n);
+   memcpy(buffer + used, str, n);
+   used += n;
+   return *this;
+}
+
+/**
+ * Append a character repeated n times.
+ *
+ * @param c the character
+ * @param n the repeat count
+ */
+OutputWriter &OutputWriter::fill(char c, size_t n) {
+   while (n > 0) {
+      reserve(1);
+      size_t chunk = std::min(n, buffer_size - used);
+      memset(buffer + used, c, chunk);
+      used += chunk;
+      n -= chunk;
+   }
+   return *this;
+}
+
+/**
+ * Append an unsigned integer in decimal, left-padded with spaces to at least width characters.
+ *
+ * @param n the integer
+ * @param width minimum field width
+ */
+OutputWriter &OutputWriter::put_uint(uint_fast64_t n, size_t width) {
+   char digits[20];
+   size_t count = 0;
+   do {
+      digits[count++] = (char) ('0' + n % 10);
+      n /= 10;
+   } while (n != 0);
+
+   if (width > count)
+      fill(' ', width - count);
+   reserve(count);
+   while (count > 0)
+      buffer[used++] = digits[--count];
+   return *this;
+}
+
+/**
+ * Append an unsigned integer in lower-case hex (no prefix), left-padded with spaces to at least width characters.
+ *
+ * @param n the integer
+ * @param width minimum field width
+ */
+OutputWriter &OutputWriter::put_hex(uint_fast64_t n, size_t width) {
+   static const char hex_digits[] = "0123456789abcdef";
+   char digits[16];
+   size_t count = 0;
+   do {
+      digits[count++] = hex_digits[n & 0xf];
+      n >>= 4;
+   } while (n != 0);
+
+   if (width > count)
+      fill(' ', width - count);
+   reserve(count);
+   while (count > 0)
+      buffer[used++] = digits[--count];
+   return *this;
+}
+
+/**
+ * Append a double with a fixed number of decimal places.
+ *
+ * @param n the value
+ * @param decimals digits after the decimal point
+ */
+OutputWriter &OutputWriter::put_fixed(double n, int decimals) {
+   char text[64];
+   int length = snprintf(text, sizeof(text), "%.*f", decimals, n);
+   return put(text, length > 0 ? (size_t) length : 0);
+}
+
+/**
+ * Append a quoted JSON string, escaping quotes, backslashes and control characters.
+ *
+ * @param str the unescaped text
+ */
+OutputWriter &OutputWriter::put_json_string(const char *str) {
+   static const char hex_digits[] = "0123456789abcdef";
+   put('"');
+   for (; *str; ++str) {
+      unsigned char c = (unsigned char) *str;
+      if (c == '"' || c == '\\') {
+         put('\\').put((char) c);
+      } else if (c < 0x20) {
+         put("\\u00", 4).put(hex_digits[c >> 4]).put(hex_digits[c & 0xf]);
+      } else {
+         put((char) c);
+      }
+   }
+   return put('"');
+}
+
+/**
+ * Append a CSV field, quoting it (and doubling embedded quotes) only when required.
+ *
+ * @param str the unescaped text
+ */
+OutputWriter &OutputWriter::put_csv_field(const char *str) {
+   if (strpbrk(str, ",\"\r\n") == nullptr)
+      return put(str);
+   put('"');
+   for (; *str; ++str) {
+      if (*str == '"')
+         put('"');
+      put(*str);
+   }
+   return put('"');
+}
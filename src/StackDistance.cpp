@@ -0,0 +1,122 @@
+/**
+ * StackDistance.cpp Source code for the StackDistance class, which measures an LRU cache level of fixed set count at
+ * every associativity up to a maximum in one pass, from the depth of each reference in its set's recency stack.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "StackDistance.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Construct an analysis with empty stacks.
+ *
+ * @param num_sets the number of sets (a power of two)
+ * @param block_size the block size in bytes (a power of two)
+ * @param max_assoc the largest associativity measured
+ */
+StackDistance::StackDistance(uint_fast32_t num_sets, uint_fast32_t block_size, uint_fast32_t max_assoc) {
+   block_length = (uint_fast32_t) log2(block_size);
+   set_mask = num_sets - 1;
+   this->max_assoc = max_assoc;
+   stacks.resize(num_sets);
+   for (std::vector<Entry> &stack : stacks)
+      stack.reserve(max_assoc + 1);
+   read_depths.assign(max_assoc + 2, 0);
+   write_depths.assign(max_assoc + 2, 0);
+   write_back_steps.assign(max_assoc + 2, 0);
+}
+
+/**
+ * READS: a read request of a given length, counted once per block it overlaps (as a cache level services it).
+ *
+ * @param addr the first address of the transfer
+ * @param bytes the length of the transfer, in bytes
+ */
+void StackDistance::read(const unsigned long &addr, uint_fast32_t bytes) {
+   for (unsigned long block = addr >> block_length; block <= (addr + bytes - 1) >> block_length; ++block)
+      reference(block, false);
+}
+
+/**
+ * WRITES: a write request of a given length, counted once per block it overlaps.
+ *
+ * @param addr the first address of the transfer
+ * @param bytes the length of the transfer, in bytes
+ */
+void StackDistance::write(const unsigned long &addr, uint_fast32_t bytes) {
+   for (unsigned long block = addr >> block_length; block <= (addr + bytes - 1) >> block_length; ++block)
+      reference(block, true);
+}
+
+/**
+ * Reference one block: record its depth, count the write backs of the caches that evicted it since its last reference,
+ * and move it to the top of its set's stack. A block pushed below max_assoc leaves the stack, and is written back by
+ * every measured cache holding it dirty.
+ *
+ * @param block the block number (address >> block_length)
+ * @param write true for a write, which dirties the block at every associativity
+ */
+void StackDistance::reference(unsigned long block, bool write) {
+   std::vector<Entry> &stack = stacks[block & set_mask];
+   size_t position = 0;
+   while (position < stack.size() && stack[position].block != block)
+      ++position;
+
+   // A block not in the stack (cold, or pushed below max_assoc) misses at every associativity
+   bool found = position < stack.size();
+   uint_fast32_t depth = found ? (uint_fast32_t) position + 1 : max_assoc + 1;
+   Entry entry = {block, max_assoc + 1};
+   if (found) {
+      entry = stack[position];
+      count_write_backs(entry.dirty_from, depth);
+      stack.erase(stack.begin() + position);
+   } else if (stack.size() == max_assoc) {
+      count_write_backs(stack.back().dirty_from, max_assoc + 1);
+      stack.pop_back();
+   }
+   (write ? write_depths : read_depths)[depth]++;
+
+   // A write dirties the block everywhere; a read misses (and re-fetches it clean) in caches of fewer than depth ways
+   entry.dirty_from = write ? 1 : std::max(entry.dirty_from, depth);
+   stack.insert(stack.begin(), entry);
+}
+
+/**
+ * Count one write back in each cache from dirty_from to evicted_below - 1 ways.
+ */
+void StackDistance::count_write_backs(uint_fast32_t dirty_from, uint_fast32_t evicted_below) {
+   if (dirty_from >= evicted_below)
+      return;
+   ++write_back_steps[dirty_from];
+   --write_back_steps[evicted_below];
+}
+
+/**
+ * Counters of the cache with the given associativity. Blocks still in the stacks below that associativity have been
+ * evicted from it, and are counted as written back if it held them dirty.
+ *
+ * @param assoc the associativity, from 1 to max_assoc
+ * @return the counters the simulator reports for that cache
+ */
+stack_counts StackDistance::counts(uint_fast32_t assoc) const {
+   stack_counts counts = {};
+   for (uint_fast32_t depth = 1; depth <= max_assoc + 1; ++depth) {
+      counts.reads += read_depths[depth];
+      counts.writes += write_depths[depth];
+      if (depth > assoc) {
+         counts.read_misses += read_depths[depth];
+         counts.write_misses += write_depths[depth];
+      }
+   }
+   for (uint_fast32_t a = 1; a <= assoc; ++a)
+      counts.write_backs += write_back_steps[a];
+   for (const std::vector<Entry> &stack : stacks)
+      for (size_t position = assoc; position < stack.size(); ++position)
+         if (stack[position].dirty_from <= assoc)
+            ++counts.write_backs;
+   return counts;
+}
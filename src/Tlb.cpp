@@ -0,0 +1,232 @@
+/**
+ * Tlb.cpp Source code for the Tlb class, which translates CPU accesses through an L1 TLB, an optional L2 TLB and a
+ * radix page table in front of the L1 cache, issuing page-table walks as reads into the cache hierarchy.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "Tlb.h"
+#include <cmath>
+
+/**
+ * Resolve defaulted parameters: fully-associative TLBs, 4 KB pages and 4 GB of physical memory.
+ *
+ * @param params the parameters to complete in place
+ */
+static void apply_defaults(tlb_params *params) {
+   if (params->l1_assoc == 0)
+      params->l1_assoc = params->l1_entries;
+   if (params->l2_assoc == 0)
+      params->l2_assoc = params->l2_entries;
+   if (params->page_size == 0)
+      params->page_size = 4096;
+   if (params->physical_memory == 0)
+      params->physical_memory = (uint_fast64_t) 4 << 30;
+}
+
+/**
+ * Construct the TLBs and the mapper. The page-table root is allocated at the base of the page-table region, directly
+ * above physical memory.
+ *
+ * @param params the TLB configuration, which must have passed validate()
+ * @param walker the level receiving page-table walk reads (the L1)
+ */
+Tlb::Tlb(const tlb_params &params, Cache *walker) {
+   this->params = params;
+   apply_defaults(&this->params);
+   this->walker = walker;
+
+   page_length = log2(this->params.page_size);
+   offset_mask = this->params.page_size - 1;
+   walk_levels = (virtual_address_length - page_length) / level_index_length;
+   initialize_level(&l1_tlb, this->params.l1_entries, this->params.l1_assoc);
+   if (this->params.l2_entries > 0)
+      initialize_level(&l2_tlb, this->params.l2_entries, this->params.l2_assoc);
+
+   // No page has been translated yet; page numbers never reach all-ones
+   last_page = ~(uint_fast64_t) 0;
+   last_frame = 0;
+
+   frame_mask = (this->params.physical_memory >> page_length) - 1;
+   table_base = this->params.physical_memory;
+   stats = {};
+   stats.page_tables = 1;
+}
+
+/**
+ * Build the sets of one TLB level.
+ *
+ * @param tlb the level to initialize
+ * @param entries the number of entries
+ * @param assoc the number of entries per set
+ */
+void Tlb::initialize_level(TlbLevel *tlb, unsigned long int entries, unsigned long int assoc) {
+   size_t qty_sets = entries / assoc;
+   for (size_t i = 0; i < qty_sets; ++i)
+      tlb->sets.emplace_back(Set(assoc));
+   tlb->frames.assign(entries, 0);
+   tlb->index_length = log2(qty_sets);
+   tlb->assoc = assoc;
+}
+
+/**
+ * Check a TLB configuration: each TLB needs a power-of-two number of sets, the page size must be 4 KB, 2 MB or 1 GB,
+ * and physical memory must be a power of two holding at least min_physical_frames pages (the mapper would otherwise
+ * alias distinct pages to the same frame after the first few).
+ *
+ * @param params the configuration to check (defaults are applied to a copy)
+ * @param error receives a description of the first problem found
+ * @return true if the configuration is valid
+ */
+bool Tlb::validate(const tlb_params &params, const char **error) {
+   tlb_params p = params;
+   apply_defaults(&p);
+   if (p.l1_entries == 0) {
+      *error = "TLB options require an L1 TLB";
+      return false;
+   }
+   const unsigned long int levels[][2] = {{p.l1_entries, p.l1_assoc}, {p.l2_entries, p.l2_assoc}};
+   for (const auto &level : levels) {
+      if (level[0] == 0)
+         continue;
+      unsigned long int qty_sets = level[1] ? level[0] / level[1] : 0;
+      if (level[1] == 0 || level[0] % level[1] != 0 || (qty_sets & (qty_sets - 1)) != 0) {
+         *error = "TLB entries must divide into a power-of-two number of sets";
+         return false;
+      }
+   }
+   if (p.page_size != 4096 && p.page_size != (2ul << 20) && p.page_size != (1ul << 30)) {
+      *error = "Page size must be 4k, 2M or 1G";
+      return false;
+   }
+   if ((p.physical_memory & (p.physical_memory - 1)) != 0) {
+      *error = "Physical memory must be a power of two";
+      return false;
+   }
+   if (p.physical_memory / p.page_size < min_physical_frames) {
+      *error = "Physical memory must hold at least 64 pages (raise --physical-memory for large pages)";
+      return false;
+   }
+   return true;
+}
+
+/*********************************************** TRANSLATION ********************************************************/
+
+/**
+ * Translate a page that is not the last translated page: look it up in the L1 TLB, then the L2 TLB, and walk the page
+ * table if both miss. The translation is filled into each TLB level that missed.
+ *
+ * @param page the virtual page number
+ * @return the physical frame number
+ */
+uint_fast64_t Tlb::translate_page(uint_fast64_t page) {
+   uint_fast64_t frame;
+   if (lookup(l1_tlb, page, &frame))
+      return frame;
+   ++stats.l1_misses;
+
+   bool has_l2 = !l2_tlb.sets.empty();
+   if (!has_l2 || !lookup(l2_tlb, page, &frame)) {
+      frame = walk(page);
+      if (has_l2) {
+         ++stats.l2_misses;
+         fill(l2_tlb, page, frame);
+      }
+   }
+   fill(l1_tlb, page, frame);
+   return frame;
+}
+
+/**
+ * Search one TLB level for a page, making the entry most recent on a hit.
+ *
+ * @param tlb the level to search
+ * @param page the virtual page number
+ * @param frame receives the physical frame number on a hit
+ * @return the entry, or nullptr on a miss
+ */
+Block *Tlb::lookup(TlbLevel &tlb, uint_fast64_t page, uint_fast64_t *frame) {
+   uint_fast64_t index = page & ((1ul << tlb.index_length) - 1);
+   Set &set = tlb.sets[index];
+   Block *entry = set.find(page >> tlb.index_length);
+   if (entry) {
+      set.make_mru(*entry);
+      *frame = tlb.frames[index * tlb.assoc + (entry - set.blocks.data())];
+   }
+   return entry;
+}
+
+/**
+ * Install a translation in one TLB level, replacing the least-recently-used entry of its set.
+ *
+ * @param tlb the level to fill
+ * @param page the virtual page number
+ * @param frame the physical frame number
+ */
+void Tlb::fill(TlbLevel &tlb, uint_fast64_t page, uint_fast64_t frame) {
+   uint_fast64_t index = page & ((1ul << tlb.index_length) - 1);
+   Set &set = tlb.sets[index];
+   Block &entry = set.lru();
+   entry.valid = true;
+   entry.tag = page >> tlb.index_length;
+   tlb.frames[index * tlb.assoc + (&entry - set.blocks.data())] = frame;
+   set.make_mru(entry);
+}
+
+/**
+ * Walk the page table for a page, reading one entry per level (four for 4 KB pages, three for 2 MB, two for 1 GB)
+ * through the L1. The reads are counted here rather than as L1 CPU reads. Page-table nodes are allocated on first use.
+ *
+ * @param page the virtual page number
+ * @return the physical frame number
+ */
+uint_fast64_t Tlb::walk(uint_fast64_t page) {
+   ++stats.walks;
+   uint_fast64_t vaddr = page << page_length;
+   uint_fast64_t node = table_base;
+   for (uint_fast32_t level = 0; level < walk_levels; ++level) {
+      uint_fast32_t shift = virtual_address_length - level_index_length * (level + 1);
+      if (level > 0)
+         node = table_node(level, vaddr >> (shift + level_index_length));
+      uint_fast64_t entry = (vaddr >> shift) & ((1ul << level_index_length) - 1);
+      ++stats.walk_reads;
+      stats.walk_read_misses += walker->page_walk_read(node + entry * entry_size, entry_size);
+   }
+   return page_frame(page);
+}
+
+/**
+ * Map a virtual page to its data frame, assigning the next frame of the allocation sequence on first touch. The
+ * sequence is scattered across physical memory by an odd-multiplier bijection; a footprint larger than physical memory
+ * wraps around and aliases earlier pages.
+ *
+ * @param page the virtual page number
+ * @return the physical frame number
+ */
+uint_fast64_t Tlb::page_frame(uint_fast64_t page) {
+   auto found = page_frames.find(page);
+   if (found != page_frames.end())
+      return found->second;
+   uint_fast64_t frame = (stats.pages_mapped++ * 0x9e3779b97f4a7c15ULL + params.mapping_seed) & frame_mask;
+   page_frames.emplace(page, frame);
+   return frame;
+}
+
+/**
+ * Find the physical address of a page-table node, allocating the next 4 KB node of the page-table region on first use.
+ *
+ * @param level the depth of the node below the root (1 or more)
+ * @param prefix the virtual address bits above those the node translates
+ * @return the physical address of the node
+ */
+uint_fast64_t Tlb::table_node(uint_fast32_t level, uint_fast64_t prefix) {
+   uint_fast64_t key = (prefix << 2) | level;
+   auto found = table_nodes.find(key);
+   if (found != table_nodes.end())
+      return found->second;
+   uint_fast64_t node = table_base + (stats.page_tables++ << table_node_length);
+   table_nodes.emplace(key, node);
+   return node;
+}
@@ -0,0 +1,88 @@
+/**
+ * TraceReader.cpp Source code for the TraceReader class, which maps (or streams) a text memory trace so that it can be
+ * parsed in place and delivered access-by-access to the memory hierarchy.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "TraceReader.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Open the trace at path and map it into memory. Files that cannot be mapped (pipes, empty files) are instead kept open
+ * and streamed through a fixed buffer by each parse. Check is_open() before parsing.
+ *
+ * @param path the trace file
+ */
+TraceReader::TraceReader(const char *path) {
+   data = nullptr;
+   length = 0;
+   mapped = false;
+   fd = -1;
+   seekable = false;
+   consumed = false;
+   opened = false;
+   lines = 0;
+   records = 0;
+   error_line = 0;
+   error_number = 0;
+
+   int file = open(path, O_RDONLY);
+   if (file < 0)
+      return;
+
+   struct stat info{};
+   if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      void *map = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+      if (map != MAP_FAILED) {
+         madvise(map, (size_t) info.st_size, MADV_SEQUENTIAL);
+         data = static_cast<const char *>(map);
+         length = (size_t) info.st_size;
+         mapped = true;
+         opened = true;
+         close(file);
+         return;
+      }
+   }
+
+   // Mapping unavailable: stream the trace when it is parsed
+   fd = file;
+   seekable = lseek(fd, 0, SEEK_CUR) == 0;
+   opened = true;
+}
+
+/**
+ * Unmap the trace if it was mapped, or close it if it was streamed.
+ */
+TraceReader::~TraceReader() {
+   if (mapped)
+      munmap(const_cast<char *>(data), length);
+   if (fd >= 0)
+      close(fd);
+}
+
+// Hex digit values indexed by character, with 0xff for every non-hex character
+const uint8_t TraceReader::hex_values[256] = {
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
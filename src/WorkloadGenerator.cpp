@@ -0,0 +1,161 @@
+/**
+ * WorkloadGenerator.cpp Source code for the WorkloadGenerator class, which synthesizes deterministic memory access
+ * streams (streaming, strided, random, Zipfian, pointer-chasing and fixed-reuse-distance) to drive the hierarchy
+ * without a trace file.
+ *
+ * Author: Stevan Dupor
+ * Copyright (C) 2021 Stevan Dupor - All Rights Reserved
+ * Unauthorized copying of this file, via any medium is strictly prohibited.
+ */
+
+#include "WorkloadGenerator.h"
+#include <cmath>
+#include <cstring>
+
+/**
+ * Construct a generator for the given workload. Zero-valued geometry falls back to defaults: a 64-byte stride, a
+ * footprint of one item, and a reuse distance of one item.
+ *
+ * @param params the workload to generate
+ */
+WorkloadGenerator::WorkloadGenerator(const workload_params &params) {
+   this->params = params;
+   if (this->params.stride == 0)
+      this->params.stride = 64;
+
+   // Round the stride (which the command line requires to be a power of two) and the item count down to powers of two
+   item_length = 0;
+   while (((uint_fast64_t) 2 << item_length) <= this->params.stride)
+      ++item_length;
+   uint_fast64_t items = this->params.footprint >> item_length;
+   item_count = 1;
+   while (item_count * 2 <= items)
+      item_count *= 2;
+   item_mask = item_count - 1;
+   stream_limit = this->params.footprint >= 4 ? this->params.footprint & ~(uint_fast64_t) 3 : 4;
+
+   if (this->params.reuse_distance == 0)
+      this->params.reuse_distance = 1;
+   if (this->params.reuse_distance > item_count)
+      this->params.reuse_distance = item_count;
+
+   // Writes are drawn by comparing 53 random bits against the write ratio
+   double ratio = this->params.write_ratio < 0 ? 0 : (this->params.write_ratio > 1 ? 1 : this->params.write_ratio);
+   write_threshold = (uint_fast64_t) std::ldexp(ratio, 53);
+
+   // Constants for Zipf sampling by rejection-inversion (Hormann & Derflinger) over ranks 1..item_count
+   if (this->params.pattern == PATTERN_ZIPF) {
+      if (this->params.zipf_alpha <= 0)
+         this->params.zipf_alpha = 0.99;
+      zipf_h_integral_x1 = zipf_h_integral(1.5) - 1.0;
+      zipf_h_integral_n = zipf_h_integral((double) item_count + 0.5);
+      zipf_s = 2.0 - zipf_h_integral_inverse(zipf_h_integral(2.5) - zipf_h(2.0));
+   } else {
+      zipf_h_integral_x1 = zipf_h_integral_n = zipf_s = 0;
+   }
+
+   reset();
+}
+
+/**
+ * Restart the access stream from the beginning. The same seed always reproduces the same sequence.
+ */
+void WorkloadGenerator::reset() {
+   rng_state = params.seed;
+   position = params.pattern == PATTERN_CHASE ? params.seed & item_mask : 0;
+}
+
+// Names of the access patterns, as given after "gen:"
+static const struct { const char *name; workload_patterns pattern; } pattern_names[] = {
+        {"stream", PATTERN_STREAM}, {"stride", PATTERN_STRIDE}, {"random", PATTERN_RANDOM},
+        {"zipf", PATTERN_ZIPF}, {"chase", PATTERN_CHASE}, {"reuse", PATTERN_REUSE}};
+
+/**
+ * Parse a pattern name.
+ *
+ * @param name one of "stream", "stride", "random", "zipf", "chase" or "reuse"
+ * @param pattern receives the parsed pattern
+ * @return true if the name was recognized
+ */
+bool WorkloadGenerator::parse_pattern(const char *name, workload_patterns *pattern) {
+   for (const auto &n : pattern_names) {
+      if (strcmp(name, n.name) == 0) {
+         *pattern = n.pattern;
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * Name a pattern, as parse_pattern accepts it.
+ *
+ * @param pattern the pattern
+ * @return the pattern's name
+ */
+const char *WorkloadGenerator::pattern_name(workload_patterns pattern) {
+   for (const auto &n : pattern_names)
+      if (n.pattern == pattern)
+         return n.name;
+   return "unknown";
+}
+
+/******************************************* ZIPF SAMPLING ***********************************************************/
+
+/**
+ * Draw a Zipf-distributed rank in 1..item_count in expected constant time, by rejection-inversion.
+ *
+ * @return the rank, where rank 1 is the most popular item
+ */
+uint_fast64_t WorkloadGenerator::next_zipf_rank() {
+   while (true) {
+      double u = zipf_h_integral_n + next_uniform() * (zipf_h_integral_x1 - zipf_h_integral_n);
+      double x = zipf_h_integral_inverse(u);
+      double k = std::floor(x + 0.5);
+      if (k < 1)
+         k = 1;
+      else if (k > (double) item_count)
+         k = (double) item_count;
+      if (k - x <= zipf_s || u >= zipf_h_integral(k + 0.5) - zipf_h(k))
+         return (uint_fast64_t) k;
+   }
+}
+
+/**
+ * Numerically stable log1p(x)/x.
+ */
+static double zipf_helper1(double x) {
+   return std::fabs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+/**
+ * Numerically stable expm1(x)/x.
+ */
+static double zipf_helper2(double x) {
+   return std::fabs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+/**
+ * The unnormalized Zipf density h(x) = x^-alpha.
+ */
+double WorkloadGenerator::zipf_h(double x) const {
+   return std::exp(-params.zipf_alpha * std::log(x));
+}
+
+/**
+ * The integral of h, with the constant chosen so that it is well-defined at alpha = 1.
+ */
+double WorkloadGenerator::zipf_h_integral(double x) const {
+   double log_x = std::log(x);
+   return zipf_helper2((1.0 - params.zipf_alpha) * log_x) * log_x;
+}
+
+/**
+ * The inverse of zipf_h_integral.
+ */
+double WorkloadGenerator::zipf_h_integral_inverse(double x) const {
+   double t = x * (1.0 - params.zipf_alpha);
+   if (t < -1.0)
+      t = -1.0;
+   return std::exp(zipf_helper1(t) * x);
+}